@@ -0,0 +1,214 @@
+#include "adaptivetessellator.h"
+#include "envelope.h"
+#include "taskpool.h"
+#include <algorithm>
+
+/**
+ * @brief AdaptiveTessellator::AdaptiveTessellator Creates a tessellator for the envelope.
+ * @param envelope Envelope to mesh. The finest cells are at least maxDepth levels finer than its sectors.
+ * @param tolerance Largest distance between the surface and the mesh, in model units.
+ * @param angleTolerance Largest angle in degrees between the normals at the corners and the centre of a cell. Not checked if 0.
+ * @param maxDepth Number of times a cell the size of a grid sector may still be split.
+ */
+AdaptiveTessellator::AdaptiveTessellator(const Envelope &envelope, float tolerance, float angleTolerance, int maxDepth) :
+    envelope(envelope),
+    tolerance(tolerance),
+    cosAngleTolerance(angleTolerance > 0 ? cos(angleTolerance * acos(-1.0f) / 180) : -2)
+{
+    // Levels needed for cells no larger than a grid sector, and the roots are never finer than the grid
+    int gridDepth = 0;
+    while ((1 << gridDepth) < std::max(envelope.getSectorsT(), envelope.getSectorsA())) gridDepth++;
+    depth = gridDepth + maxDepth;
+    rootDepth = 0;
+    while ((2 << rootDepth) <= RootCells && rootDepth < gridDepth) rootDepth++;
+}
+
+/**
+ * @brief AdaptiveTessellator::Sampler::at Gives the position and normal of the envelope at the lattice point (x,y).
+ */
+AdaptiveTessellator::Sample AdaptiveTessellator::Sampler::at(int x, int y)
+{
+    quint64 k = key(x, y);
+    auto it = samples.constFind(k);
+    if (it != samples.constEnd()) return *it;
+
+    auto frame = frames.find(x);
+    if (frame == frames.end()) {
+        frame = frames.insert(x, tessellator->envelope.computeFrameAt(tessellator->tAt(x), 1));
+    }
+    EnvelopeJet jet = tessellator->envelope.evaluateJet(*frame, tessellator->aAt(y), 0);
+    Sample sample;
+    sample.position = jet.position[0];
+    sample.normal = jet.normal[0];
+    samples.insert(k, sample);
+    return sample;
+}
+
+/**
+ * @brief AdaptiveTessellator::isFlat Checks whether the cell is within the tolerances, from the midpoints of its edges and its centre.
+ */
+bool AdaptiveTessellator::isFlat(const Cell &cell, Sampler &sampler) const
+{
+    if (cell.size == 1) return true;
+
+    int x0 = cell.x, x1 = cell.x + cell.size, xm = cell.x + cell.size / 2;
+    int y0 = cell.y, y1 = cell.y + cell.size, ym = cell.y + cell.size / 2;
+    Sample c00 = sampler.at(x0, y0);
+    Sample c10 = sampler.at(x1, y0);
+    Sample c01 = sampler.at(x0, y1);
+    Sample c11 = sampler.at(x1, y1);
+    Sample center = sampler.at(xm, ym);
+
+    // Chordal error of the edges and of the bilinear patch
+    if ((sampler.at(xm, y0).position - (c00.position + c10.position) / 2).length() > tolerance) return false;
+    if ((sampler.at(x1, ym).position - (c10.position + c11.position) / 2).length() > tolerance) return false;
+    if ((sampler.at(xm, y1).position - (c01.position + c11.position) / 2).length() > tolerance) return false;
+    if ((sampler.at(x0, ym).position - (c00.position + c01.position) / 2).length() > tolerance) return false;
+    QVector3D bilinear = (c00.position + c10.position + c01.position + c11.position) / 4;
+    if ((center.position - bilinear).length() > tolerance) return false;
+
+    // Normal deviation
+    for (const Sample *corner : {&c00, &c10, &c01, &c11}) {
+        if (QVector3D::dotProduct(corner->normal, center.normal) < cosAngleTolerance) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief AdaptiveTessellator::refine Splits the cell until all its leaves are flat, and appends the leaves.
+ */
+void AdaptiveTessellator::refine(const Cell &cell, Sampler &sampler, QVector<Cell> &leaves) const
+{
+    if (isFlat(cell, sampler)) {
+        leaves.append(cell);
+        return;
+    }
+    int half = cell.size / 2;
+    refine({cell.x, cell.y, half}, sampler, leaves);
+    refine({cell.x + half, cell.y, half}, sampler, leaves);
+    refine({cell.x, cell.y + half, half}, sampler, leaves);
+    refine({cell.x + half, cell.y + half, half}, sampler, leaves);
+}
+
+/**
+ * @brief AdaptiveTessellator::tessellate Meshes the envelope. Vertices hold the position and the normal, like the uniform mesh.
+ * @param vertices Filled with the vertices.
+ * @param indices Filled with three indices per triangle.
+ * @param parameters If not null, filled with the (t,a) parameters of the vertices.
+ */
+void AdaptiveTessellator::tessellate(QVector<EnvelopeVertex> &vertices, QVector<unsigned int> &indices, QVector<QVector2D> *parameters) const
+{
+    int numRoots = 1 << rootDepth;
+    int rootSize = 1 << (depth - rootDepth);
+
+    // Refine the roots concurrently, each into its own leaves so that the mesh does not depend on the order they finish in
+    QVector<QVector<Cell>> rootLeaves(numRoots * numRoots);
+    QVector<Cell> *rootLeavesData = rootLeaves.data();
+    TaskPool::instance()->parallelFor(0, numRoots * numRoots, [&](int root) {
+        Sampler sampler{this, {}, {}};
+        refine({(root / numRoots) * rootSize, (root % numRoots) * rootSize, rootSize}, sampler, rootLeavesData[root]);
+    }, 1, "tessellation root");
+
+    // The corners of all leaves on every vertical line x and horizontal line y
+    QHash<int, QVector<int>> linesX;
+    QHash<int, QVector<int>> linesY;
+    for (const QVector<Cell> &leaves : rootLeaves) {
+        for (const Cell &cell : leaves) {
+            for (int x : {cell.x, cell.x + cell.size}) {
+                for (int y : {cell.y, cell.y + cell.size}) {
+                    linesX[x].append(y);
+                    linesY[y].append(x);
+                }
+            }
+        }
+    }
+    for (QHash<int, QVector<int>> *lines : {&linesX, &linesY}) {
+        for (auto it = lines->begin(); it != lines->end(); ++it) {
+            std::sort(it->begin(), it->end());
+            it->erase(std::unique(it->begin(), it->end()), it->end());
+        }
+    }
+
+    // Triangulate every leaf, as a fan around its centre if finer neighbours put corners on its edges
+    QHash<quint64, unsigned int> vertexOf;
+    QVector<Cell> points;
+    auto vertex = [&](int x, int y) {
+        quint64 k = key(x, y);
+        auto it = vertexOf.constFind(k);
+        if (it != vertexOf.constEnd()) return *it;
+        unsigned int i = points.size();
+        points.append({x, y, 0});
+        vertexOf.insert(k, i);
+        return i;
+    };
+    // Appends the corners on a line that lie in [from, to), walking from from towards to
+    QVector<unsigned int> polygon;
+    auto appendEdge = [&](const QVector<int> &line, bool vertical, int fixed, int from, int to) {
+        if (from < to) {
+            for (auto it = std::lower_bound(line.begin(), line.end(), from); it != line.end() && *it < to; ++it) {
+                polygon.append(vertical ? vertex(fixed, *it) : vertex(*it, fixed));
+            }
+        } else {
+            auto it = std::upper_bound(line.begin(), line.end(), from);
+            while (it != line.begin() && *(it - 1) > to) {
+                --it;
+                polygon.append(vertical ? vertex(fixed, *it) : vertex(*it, fixed));
+            }
+        }
+    };
+
+    indices.clear();
+    for (const QVector<Cell> &leaves : rootLeaves) {
+        for (const Cell &cell : leaves) {
+            int x0 = cell.x, x1 = cell.x + cell.size;
+            int y0 = cell.y, y1 = cell.y + cell.size;
+
+            // Counter clockwise in (t,a), like the triangles of the uniform grid
+            polygon.clear();
+            appendEdge(linesY[y0], false, y0, x0, x1);
+            appendEdge(linesX[x1], true, x1, y0, y1);
+            appendEdge(linesY[y1], false, y1, x1, x0);
+            appendEdge(linesX[x0], true, x0, y1, y0);
+
+            if (polygon.size() == 4) {
+                indices << polygon[0] << polygon[2] << polygon[3];
+                indices << polygon[0] << polygon[1] << polygon[2];
+                continue;
+            }
+            unsigned int center = vertex(x0 + cell.size / 2, y0 + cell.size / 2);
+            for (int k = 0; k < polygon.size(); k++) {
+                indices << center << polygon[k] << polygon[(k + 1) % polygon.size()];
+            }
+        }
+    }
+
+    // Evaluate the vertices, computing the frame of every t column once
+    QVector<int> columns;
+    for (const Cell &point : points) columns.append(point.x);
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+    QVector<EnvelopeFrame> frames(columns.size());
+    EnvelopeFrame *framesData = frames.data();
+    // The workers only read through constData, as non-const accessors of a shared vector may detach it
+    const int *columnsData = columns.constData();
+    const int *columnsEnd = columnsData + columns.size();
+    TaskPool::instance()->parallelFor(0, columns.size(), [&](int i) {
+        framesData[i] = envelope.computeFrameAt(tAt(columnsData[i]), 1);
+    }, 1, "tessellation frame");
+
+    vertices.resize(points.size());
+    EnvelopeVertex *verticesData = vertices.data();
+    const Cell *pointsData = points.constData();
+    TaskPool::instance()->parallelFor(0, points.size(), [&](int i) {
+        int column = std::lower_bound(columnsData, columnsEnd, pointsData[i].x) - columnsData;
+        EnvelopeJet jet = envelope.evaluateJet(framesData[column], aAt(pointsData[i].y), 0);
+        verticesData[i] = EnvelopeVertex(jet.position[0], jet.normal[0]);
+    }, 64, "tessellation vertex");
+
+    if (parameters != nullptr) {
+        parameters->resize(points.size());
+        for (int i = 0; i < points.size(); i++) {
+            (*parameters)[i] = QVector2D(tAt(points[i].x), aAt(points[i].y));
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef ADAPTIVETESSELLATOR_H
+#define ADAPTIVETESSELLATOR_H
+
+#include <QHash>
+#include <QVector>
+#include <QVector2D>
+#include <QVector3D>
+#include "envelopevertex.h"
+#include "envelopeframe.h"
+
+class Envelope;
+
+/**
+ * @brief The AdaptiveTessellator class meshes an envelope with triangles that are refined where the surface bends.
+ * The (t,a) domain is split into a coarse root grid of at most RootCells x RootCells cells, and every root is the root of a quadtree
+ * that is split until the chordal error and the normal deviation of its cells are below their tolerances. Flat regions therefore keep
+ * cells that are larger than those of the uniform sectorsT x sectorsA grid. Cells are triangulated as fans that include the corners
+ * of finer neighbouring cells on their edges, so the mesh has no cracks.
+ */
+class AdaptiveTessellator
+{
+public:
+    // Roots per side of the (t,a) domain, refined concurrently
+    static const int RootCells = 8;
+
+    // Cell of the quadtree, in units of the finest level
+    struct Cell {
+        int x, y, size;
+    };
+
+private:
+    // Position and normal at one point of the finest lattice
+    struct Sample {
+        QVector3D position;
+        QVector3D normal;
+    };
+
+    /**
+     * @brief The Sampler struct evaluates the envelope at lattice points, and caches the samples and the frames of the t columns it evaluated.
+     */
+    struct Sampler {
+        const AdaptiveTessellator *tessellator;
+        QHash<int, EnvelopeFrame> frames;
+        QHash<quint64, Sample> samples;
+
+        Sample at(int x, int y);
+    };
+
+    const Envelope &envelope;
+    float tolerance;
+    float cosAngleTolerance;
+    // Levels of the quadtree below the whole domain, and the level of the roots
+    int depth;
+    int rootDepth;
+
+public:
+    AdaptiveTessellator(const Envelope &envelope, float tolerance, float angleTolerance = 0, int maxDepth = 5);
+
+    void tessellate(QVector<EnvelopeVertex> &vertices, QVector<unsigned int> &indices, QVector<QVector2D> *parameters = nullptr) const;
+
+private:
+    inline float tAt(int x) const { return (float) x / (1 << depth); }
+    inline float aAt(int y) const { return (float) y / (1 << depth); }
+    static inline quint64 key(int x, int y) { return ((quint64) (quint32) x << 32) | (quint32) y; }
+
+    void refine(const Cell &cell, Sampler &sampler, QVector<Cell> &leaves) const;
+    bool isFlat(const Cell &cell, Sampler &sampler) const;
+};
+
+#endif // ADAPTIVETESSELLATOR_H
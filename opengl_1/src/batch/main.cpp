@@ -0,0 +1,188 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+#include "../meshexporter.h"
+#include "../profiler.h"
+#include "../scene.h"
+#include "../taskpool.h"
+
+/**
+ * @brief writeObj Writes the mesh of an envelope as a Wavefront OBJ file, with the normals of the vertices.
+ * @return False if the file cannot be written.
+ */
+static bool writeObj(const Envelope &env, const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    QTextStream out(&file);
+
+    for (const EnvelopeVertex &v : env.getVertexArr()) {
+        out << "v " << v.xCoord << ' ' << v.yCoord << ' ' << v.zCoord << '\n';
+    }
+    for (const EnvelopeVertex &v : env.getVertexArr()) {
+        QVector3D n = v.getNormal();
+        out << "vn " << n.x() << ' ' << n.y() << ' ' << n.z() << '\n';
+    }
+    const QVector<unsigned int> &indices = env.getIndexArr();
+    for (int i = 0; i + 2 < indices.size(); i += 3) {
+        out << 'f';
+        for (int k = 0; k < 3; k++) out << ' ' << indices[i + k] + 1 << "//" << indices[i + k] + 1;
+        out << '\n';
+    }
+    return out.status() == QTextStream::Ok && file.error() == QFile::NoError;
+}
+
+/**
+ * @brief writeSamples Writes the position and normal at every (t,a) node of the grids of all envelopes as CSV, sampling the grids
+ * that adaptive meshes left out.
+ * @return False if the file cannot be written.
+ */
+static bool writeSamples(const Scene &scene, const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    QTextStream out(&file);
+
+    out << "envelope,t,a,x,y,z,nx,ny,nz\n";
+    for (Envelope *env : scene.getEnvelopes()) {
+        env->sampleGrid();
+        for (int tIdx = 0; tIdx <= env->getGridSectorsT(); tIdx++) {
+            for (int aIdx = 0; aIdx <= env->getGridSectorsA(); aIdx++) {
+                QVector3D p = env->getGridPositions()[env->gridIndex(tIdx, aIdx)];
+                QVector3D n = env->getGridNormals()[env->gridIndex(tIdx, aIdx)];
+                out << env->getIndex() << ',' << (float) tIdx / env->getGridSectorsT() << ',' << (float) aIdx / env->getGridSectorsA() << ','
+                    << p.x() << ',' << p.y() << ',' << p.z() << ',' << n.x() << ',' << n.y() << ',' << n.z() << '\n';
+            }
+        }
+    }
+    return out.status() == QTextStream::Ok && file.error() == QFile::NoError;
+}
+
+/**
+ * @brief main Entry point of the batch tool. Computes the envelopes of scene files without a window or an OpenGL context,
+ * and writes their meshes and samples. Prints the timings of every scene.
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("envelope_batch");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Computes the envelopes of scene files and writes their meshes and samples.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("scenes", "Scene files, or directories whose .json and .envs files are all processed.", "scenes...");
+    QCommandLineOption outputOption({"o", "output"}, "Directory to write to.", "directory", ".");
+    QCommandLineOption threadsOption("threads", "Number of worker threads of the task pool, 0 for one per core.", "count", "0");
+    QCommandLineOption serialOption("serial", "Compute every scene on one thread.");
+    QCommandLineOption noMeshOption("no-mesh", "Do not write the meshes.");
+    QCommandLineOption formatOption("format", "Format of the meshes: obj, ply or stl.", "format", "obj");
+    QCommandLineOption parametersOption("parameters", "Write the (t,a) parameters of the vertices to PLY meshes.");
+    QCommandLineOption noSamplesOption("no-samples", "Do not write the samples.");
+    QCommandLineOption timingsOption("timings", "CSV file to write the timings of the compute stages to.", "file");
+    parser.addOptions({outputOption, threadsOption, serialOption, noMeshOption, formatOption, parametersOption, noSamplesOption,
+                       timingsOption});
+    parser.process(app);
+
+    QString meshFormat = parser.value(formatOption).toLower();
+    if (meshFormat != "obj" && meshFormat != "ply" && meshFormat != "stl") {
+        qCritical() << "Unknown mesh format" << meshFormat;
+        return 1;
+    }
+
+    TaskPool::instance()->setThreadCount(parser.value(threadsOption).toInt());
+    Profiler::instance()->setEnabled(parser.isSet(timingsOption));
+
+    QStringList sceneFiles;
+    for (const QString &arg : parser.positionalArguments()) {
+        QFileInfo info(arg);
+        if (info.isDir()) {
+            for (const QFileInfo &entry : QDir(arg).entryInfoList({"*.json", "*.envs"}, QDir::Files, QDir::Name)) {
+                sceneFiles.append(entry.filePath());
+            }
+        } else {
+            sceneFiles.append(arg);
+        }
+    }
+    if (sceneFiles.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    QDir outputDir(parser.value(outputOption));
+    if (!outputDir.mkpath(".")) {
+        qCritical() << "Cannot create output directory" << outputDir.path();
+        return 1;
+    }
+
+    QTextStream out(stdout);
+    out << "scene,envelopes,triangles,load_ms,compute_ms,write_ms\n";
+    int numFailed = 0;
+    double totalComputeMs = 0;
+    QElapsedTimer total;
+    total.start();
+
+    for (const QString &sceneFile : sceneFiles) {
+        QElapsedTimer timer;
+        timer.start();
+        Scene scene;
+        QString error;
+        if (!scene.loadFile(sceneFile, error)) {
+            qWarning().noquote() << sceneFile << ":" << error;
+            numFailed++;
+            continue;
+        }
+        double loadMs = timer.nsecsElapsed() / 1e6;
+
+        timer.restart();
+        scene.compute(!parser.isSet(serialOption));
+        double computeMs = timer.nsecsElapsed() / 1e6;
+        totalComputeMs += computeMs;
+
+        timer.restart();
+        QString base = outputDir.filePath(QFileInfo(sceneFile).completeBaseName());
+        bool written = true;
+        qsizetype numTriangles = 0;
+        for (const Envelope *env : scene.getEnvelopes()) {
+            numTriangles += env->getIndexArr().size() / 3;
+            if (parser.isSet(noMeshOption)) continue;
+            QString meshFile = QString("%1_%2.%3").arg(base).arg(env->getIndex()).arg(meshFormat);
+            if (meshFormat == "obj") {
+                written &= writeObj(*env, meshFile);
+            } else {
+                QString error;
+                if (!MeshExporter::exportEnvelope(*env, meshFile, error, parser.isSet(parametersOption))) {
+                    qWarning().noquote() << meshFile << ":" << error;
+                    written = false;
+                }
+            }
+        }
+        if (!parser.isSet(noSamplesOption)) {
+            written &= writeSamples(scene, base + "_samples.csv");
+        }
+        double writeMs = timer.nsecsElapsed() / 1e6;
+        if (!written) {
+            qWarning().noquote() << sceneFile << ": cannot write the output";
+            numFailed++;
+        }
+
+        out << sceneFile << ',' << scene.getEnvelopes().size() << ',' << numTriangles << ','
+            << loadMs << ',' << computeMs << ',' << writeMs << Qt::endl;
+    }
+
+    if (parser.isSet(timingsOption)) {
+        QString error;
+        if (!Profiler::instance()->saveCsv(parser.value(timingsOption), error)) {
+            qWarning().noquote() << parser.value(timingsOption) << ":" << error;
+            numFailed++;
+        }
+    }
+
+    int numDone = sceneFiles.size() - numFailed;
+    qInfo().noquote() << QString("%1 scenes done, %2 failed, %3 ms computing (%4 ms per scene), %5 ms in total")
+                         .arg(numDone).arg(numFailed).arg(totalComputeMs, 0, 'f', 1)
+                         .arg(numDone > 0 ? totalComputeMs / numDone : 0, 0, 'f', 2).arg(total.elapsed());
+    return numFailed > 0 ? 1 : 0;
+}
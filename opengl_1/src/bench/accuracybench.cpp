@@ -0,0 +1,270 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QPair>
+#include <QSaveFile>
+#include <QTextStream>
+#include <functional>
+
+#include "benchmark.h"
+#include "scenariogenerator.h"
+#include "../scene.h"
+
+namespace {
+
+// Step of the finite differences. A power of two, so that t ± h and the division by it are exact
+const float Step = 1.0f / 64;
+// Relative error above which a kernel is reported as suspect
+const double SuspectError = 1e-2;
+
+using Function = std::function<QVector3D(float, float)>;
+
+/**
+ * @brief The Kernel struct is a derivative of the envelope, its normals, its path or its axis, together with the function it is
+ * the derivative of, to which finite differences are applied.
+ */
+struct Kernel {
+    QString name;
+    Function value;
+    Function lower;
+};
+
+QVector<Kernel> kernels(const Envelope *env)
+{
+    using SurfaceFunction = QVector3D (Envelope::*)(float, float) const;
+    using CurveFunction = QVector3D (Envelope::*)(float) const;
+    auto surface = [env](SurfaceFunction f) -> Function { return [env, f](float t, float a) { return (env->*f)(t, a); }; };
+    auto curve = [env](CurveFunction f) -> Function { return [env, f](float t, float) { return (env->*f)(t); }; };
+
+    return {
+        {"envelope/getEnvelopeDtAt", surface(&Envelope::getEnvelopeDtAt), surface(&Envelope::getEnvelopeAt)},
+        {"envelope/getEnvelopeDt2At", surface(&Envelope::getEnvelopeDt2At), surface(&Envelope::getEnvelopeDtAt)},
+        {"envelope/getEnvelopeDt3At", surface(&Envelope::getEnvelopeDt3At), surface(&Envelope::getEnvelopeDt2At)},
+        {"envelope/getNormalDtAt", surface(&Envelope::getNormalDtAt), surface(&Envelope::getNormalAt)},
+        {"envelope/getNormalDt2At", surface(&Envelope::getNormalDt2At), surface(&Envelope::getNormalDtAt)},
+        {"envelope/getNormalDt3At", surface(&Envelope::getNormalDt3At), surface(&Envelope::getNormalDt2At)},
+        {"envelope/getPathDtAt", curve(&Envelope::getPathDtAt), curve(&Envelope::getPathAt)},
+        {"envelope/getPathDt2At", curve(&Envelope::getPathDt2At), curve(&Envelope::getPathDtAt)},
+        {"envelope/getPathDt3At", curve(&Envelope::getPathDt3At), curve(&Envelope::getPathDt2At)},
+        {"envelope/getPathDt4At", curve(&Envelope::getPathDt4At), curve(&Envelope::getPathDt3At)},
+        {"envelope/getAxisDtAt", curve(&Envelope::getAxisDtAt), curve(&Envelope::getAxisAt)},
+        {"envelope/getAxisDt2At", curve(&Envelope::getAxisDt2At), curve(&Envelope::getAxisDtAt)},
+        {"envelope/getAxisDt3At", curve(&Envelope::getAxisDt3At), curve(&Envelope::getAxisDt2At)},
+        {"envelope/getAxisDt4At", curve(&Envelope::getAxisDt4At), curve(&Envelope::getAxisDt3At)},
+    };
+}
+
+/**
+ * @brief finiteDifference Returns the derivative of f in t, from central differences with steps h and h/2 combined by Richardson
+ * extrapolation, which makes the error of the differences fourth order in h.
+ */
+QVector3D finiteDifference(const Function &f, float t, float a)
+{
+    QVector3D coarse = (f(t + Step, a) - f(t - Step, a)) / (2 * Step);
+    QVector3D fine = (f(t + Step / 2, a) - f(t - Step / 2, a)) / Step;
+    return (4 * fine - coarse) / 3;
+}
+
+/**
+ * @brief samples Returns (t,a) pairs spread over the parameter domain. t keeps a margin from the ends, so that the finite differences
+ * do not reach past them.
+ */
+QVector<QVector2D> samples()
+{
+    const int numT = 24;
+    const int numA = 5;
+    QVector<QVector2D> result;
+    for (int i = 0; i < numT; i++) {
+        for (int j = 0; j < numA; j++) {
+            result.append(QVector2D(0.05f + 0.9f * (i + 0.31f) / numT, (float) j / (numA - 1)));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief The Errors struct accumulates the differences between computed vectors and the vectors they are checked against.
+ */
+struct Errors {
+    double max = 0;
+    double sumOfSquares = 0;
+    double scale = 0;
+    int count = 0;
+
+    inline void add(const QVector3D &value, const QVector3D &expected) {
+        double error = (value - expected).length();
+        max = std::max(max, error);
+        sumOfSquares += error * error;
+        scale = std::max(scale, (double) expected.length());
+        count++;
+    }
+    inline double rms() const { return count > 0 ? std::sqrt(sumOfSquares / count) : 0; }
+    // Relative to the largest expected vector, as derivatives pass through zero
+    inline double relative() const { return max / std::max(scale, 1e-6); }
+};
+
+QJsonArray toJson(const QVector<QVector3D> &values)
+{
+    QJsonArray array;
+    for (const QVector3D &v : values) {
+        array.append(v.x());
+        array.append(v.y());
+        array.append(v.z());
+    }
+    return array;
+}
+
+QJsonObject readJsonFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qFatal("Cannot read %s", qPrintable(fileName));
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+}
+
+/**
+ * @brief main Entry point of the accuracy benchmark. Compares the derivatives of envelopes, their normals, paths and axes with finite
+ * differences of the functions they are derivatives of, for envelopes of every kind of continuity, and times them.
+ * The jets computed by propagating Taylor series are compared with the ones of the hand-derived formulas for every order.
+ * The values can be written to a reference file and compared with the ones of another build, such as one with a faster evaluator.
+ * Kernels whose error exceeds one percent of their size are reported as suspect.
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("envelope_accuracybench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Checks the derivatives of the envelopes against finite differences and a reference, and times them.");
+    parser.addHelpOption();
+    QCommandLineOption jsonOption("json", "File to write the results to as JSON.", "file");
+    QCommandLineOption filterOption("filter", "Only run kernels whose name contains this text.", "text");
+    QCommandLineOption minTimeOption("min-time", "Minimum time of every timed batch in milliseconds.", "ms", "20");
+    QCommandLineOption repetitionsOption("repetitions", "Number of timed batches per kernel.", "count", "3");
+    QCommandLineOption writeReferenceOption("write-reference", "File to write the values of all kernels to.", "file");
+    QCommandLineOption referenceOption("reference", "File of values written by another build to compare with.", "file");
+    QCommandLineOption strictOption("strict", "Exit with an error if any kernel is suspect.");
+    parser.addOptions({jsonOption, filterOption, minTimeOption, repetitionsOption, writeReferenceOption, referenceOption, strictOption});
+    parser.process(app);
+
+    Benchmark bench;
+    bench.setFilter(parser.value(filterOption));
+    bench.setMinBatchMs(parser.value(minTimeOption).toInt());
+    bench.setRepetitions(parser.value(repetitionsOption).toInt());
+    QJsonObject reference;
+    if (parser.isSet(referenceOption)) {
+        reference = readJsonFile(parser.value(referenceOption));
+    }
+
+    SceneDescription drum = ScenarioGenerator::chains(1, 1, 20, 50);
+    drum.envelopes[0].toolType = Tool_Drum;
+    // The last envelope of every scene is checked
+    const QList<QPair<QString, SceneDescription>> scenes = {
+        {"cylinder", ScenarioGenerator::chains(1, 1, 20, 50)},
+        {"drum", drum},
+        {"tangent-drum", ScenarioGenerator::chains(1, 2, 20, 50)},
+        {"tangent-cylinder", ScenarioGenerator::chains(1, 3, 20, 50)},
+        {"constrained", ScenarioGenerator::bridges(1, 20, 50)},
+    };
+    const QVector<QVector2D> ta = samples();
+    QJsonObject written;
+    int numSuspect = 0;
+    QTextStream out(stdout);
+
+    for (const auto &scene : scenes) {
+        Scene computed;
+        QString error;
+        if (!computed.load(scene.second, error)) {
+            qFatal("Invalid generated scene: %s", qPrintable(error));
+        }
+        computed.compute(false);
+
+        for (const Kernel &kernel : kernels(computed.getEnvelopes().last())) {
+            QString key = scene.first + "/" + kernel.name;
+            QVector<QVector3D> values;
+            for (const QVector2D &p : ta) values.append(kernel.value(p.x(), p.y()));
+            written[key] = toJson(values);
+
+            int i = 0;
+            bool ran = bench.run("accuracy/" + kernel.name, {{"scene", scene.first}}, [&]() {
+                const QVector2D &p = ta[i++ % ta.size()];
+                Benchmark::keep(kernel.value(p.x(), p.y()));
+            });
+            if (!ran) continue;
+
+            Errors differences;
+            for (int s = 0; s < ta.size(); s++) {
+                differences.add(values[s], finiteDifference(kernel.lower, ta[s].x(), ta[s].y()));
+            }
+            bench.setCounter("fd_max_error", differences.max);
+            bench.setCounter("fd_rms_error", differences.rms());
+            bench.setCounter("fd_relative_error", differences.relative());
+            if (differences.relative() > SuspectError) {
+                out << "    SUSPECT: " << key << " differs from the finite differences by "
+                    << QString::number(100 * differences.relative(), 'f', 2) << "% of its size" << Qt::endl;
+                numSuspect++;
+            }
+
+            if (reference.contains(key)) {
+                QJsonArray expected = reference[key].toArray();
+                Errors referenceErrors;
+                for (int s = 0; s < ta.size() && 3 * s + 2 < expected.size(); s++) {
+                    QVector3D v(expected.at(3 * s).toDouble(), expected.at(3 * s + 1).toDouble(), expected.at(3 * s + 2).toDouble());
+                    referenceErrors.add(values[s], v);
+                }
+                bench.setCounter("reference_max_error", referenceErrors.max);
+                bench.setCounter("reference_rms_error", referenceErrors.rms());
+            }
+        }
+
+        // The Taylor series jets that evaluateJet does not use are checked against the hand-derived formulas it uses instead
+        const Envelope *env = computed.getEnvelopes().last();
+        QVector<EnvelopeFrame> frames;
+        for (const QVector2D &p : ta) frames.append(env->computeFrameAt(p.x(), EnvelopeJet::MAX_ORDER + 1));
+        for (int order = 1; order <= EnvelopeJet::MAX_ORDER; order++) {
+            int i = 0;
+            bool ran = bench.run("accuracy/evaluateJetTaylor", {{"scene", scene.first}, {"order", order}}, [&]() {
+                int s = i++ % ta.size();
+                Benchmark::keep(env->evaluateJetTaylor(frames[s], ta[s].y(), order));
+            });
+            if (!ran) continue;
+
+            Errors positions, normals;
+            for (int s = 0; s < ta.size(); s++) {
+                EnvelopeJet taylor = env->evaluateJetTaylor(frames[s], ta[s].y(), order);
+                EnvelopeJet formulas = env->evaluateJet(frames[s], ta[s].y(), order);
+                positions.add(taylor.position[order], formulas.position[order]);
+                normals.add(taylor.normal[order], formulas.normal[order]);
+            }
+            bench.setCounter("position_relative_difference", positions.relative());
+            bench.setCounter("normal_relative_difference", normals.relative());
+            if (std::max(positions.relative(), normals.relative()) > SuspectError) {
+                out << "    SUSPECT: " << scene.first << "/evaluateJetTaylor order " << order << " differs from evaluateJet by "
+                    << QString::number(100 * std::max(positions.relative(), normals.relative()), 'f', 2) << "% of its size" << Qt::endl;
+                numSuspect++;
+            }
+        }
+    }
+    out << numSuspect << " suspect kernels" << Qt::endl;
+
+    if (parser.isSet(writeReferenceOption)) {
+        QSaveFile file(parser.value(writeReferenceOption));
+        if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(written).toJson()) < 0 || !file.commit()) {
+            qCritical() << "Cannot write" << parser.value(writeReferenceOption);
+            return 1;
+        }
+    }
+    if (parser.isSet(jsonOption)) {
+        QJsonObject context;
+        context["executable"] = QCoreApplication::applicationName();
+        context["finite_difference_step"] = Step;
+        if (!bench.saveJson(parser.value(jsonOption), context)) {
+            qCritical() << "Cannot write" << parser.value(jsonOption);
+            return 1;
+        }
+    }
+    return parser.isSet(strictOption) && numSuspect > 0 ? 2 : 0;
+}
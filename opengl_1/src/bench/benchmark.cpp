@@ -0,0 +1,96 @@
+#include "benchmark.h"
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+
+/**
+ * @brief Benchmark::isSelected Whether a case runs, which is when its name contains the filter.
+ */
+bool Benchmark::isSelected(const QString &name) const
+{
+    return filter.isEmpty() || name.contains(filter);
+}
+
+/**
+ * @brief Benchmark::record Stores the result of a case and prints it.
+ * @param perIteration Time per iteration of every repetition, in nanoseconds. Sorted in place.
+ */
+void Benchmark::record(const QString &name, const QJsonObject &params, qint64 iterations, QVector<double> &perIteration)
+{
+    std::sort(perIteration.begin(), perIteration.end());
+    double sum = 0;
+    for (double ns : perIteration) sum += ns;
+
+    Result result;
+    result.name = name;
+    result.params = params;
+    result.iterations = iterations;
+    result.repetitions = perIteration.size();
+    result.minNs = perIteration.first();
+    result.medianNs = perIteration[perIteration.size() / 2];
+    result.meanNs = sum / perIteration.size();
+    results.append(result);
+
+    QStringList paramText;
+    for (const QString &key : params.keys()) {
+        paramText.append(QString("%1=%2").arg(key, params[key].toVariant().toString()));
+    }
+    QTextStream out(stdout);
+    out << QString("%1 %2").arg(name, -40).arg(paramText.join(' '), -48)
+        << QString("%1 ns  (min %2, %3 iterations)").arg(result.medianNs, 12, 'f', 1).arg(result.minNs, 0, 'f', 1).arg(iterations)
+        << Qt::endl;
+}
+
+/**
+ * @brief Benchmark::setCounter Attaches a measured quantity other than time, such as the memory used, to the last result.
+ */
+void Benchmark::setCounter(const QString &key, double value)
+{
+    if (results.isEmpty()) return;
+    results.last().counters[key] = value;
+    QTextStream(stdout) << QString("    %1 = %2").arg(key).arg(value, 0, 'g', 10) << Qt::endl;
+}
+
+/**
+ * @brief Benchmark::toJson Returns all results, with times in nanoseconds per iteration.
+ */
+QJsonObject Benchmark::toJson() const
+{
+    QJsonArray array;
+    for (const Result &result : results) {
+        QJsonObject json;
+        json["name"] = result.name;
+        json["params"] = result.params;
+        json["iterations"] = result.iterations;
+        json["repetitions"] = result.repetitions;
+        json["ns_min"] = result.minNs;
+        json["ns_median"] = result.medianNs;
+        json["ns_mean"] = result.meanNs;
+        if (!result.counters.isEmpty()) json["counters"] = result.counters;
+        array.append(json);
+    }
+    QJsonObject json;
+    json["benchmarks"] = array;
+    return json;
+}
+
+/**
+ * @brief Benchmark::saveJson Writes all results to a JSON file, together with a description of the run.
+ * @param context Information about the run, to which the date and the number of cores are added.
+ * @return False if the file cannot be written.
+ */
+bool Benchmark::saveJson(const QString &fileName, const QJsonObject &context) const
+{
+    QJsonObject fullContext = context;
+    fullContext["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    fullContext["cores"] = QThread::idealThreadCount();
+    QJsonObject json = toJson();
+    json["context"] = fullContext;
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(json).toJson());
+    return file.commit();
+}
@@ -0,0 +1,97 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <algorithm>
+
+/**
+ * @brief The Benchmark class times small pieces of code and collects the results as JSON.
+ * Every case is first calibrated to find an iteration count that runs for at least the minimum batch time, then timed over a number of
+ * repetitions of that many iterations. The minimum, median and mean time per iteration over the repetitions are reported.
+ */
+class Benchmark
+{
+public:
+    struct Result {
+        QString name;
+        QJsonObject params;
+        qint64 iterations;
+        int repetitions;
+        double minNs;
+        double medianNs;
+        double meanNs;
+        QJsonObject counters;
+    };
+
+private:
+    QString filter;
+    qint64 minBatchNs = 20000000;
+    int repetitions = 5;
+    QVector<Result> results;
+
+public:
+    inline void setFilter(const QString &value) { filter = value; }
+    inline void setMinBatchMs(int ms) { minBatchNs = (qint64) ms * 1000000; }
+    inline void setRepetitions(int value) { repetitions = std::max(value, 1); }
+    inline const QVector<Result> &getResults() const { return results; }
+
+    bool isSelected(const QString &name) const;
+
+    /**
+     * @brief run Times body, which is called once per iteration. Cases whose name does not contain the filter are skipped.
+     * @param params Parameters of the case, such as the sector count, stored with the result.
+     * @return Whether the case ran.
+     */
+    template<typename Body>
+    bool run(const QString &name, const QJsonObject &params, Body body) {
+        if (!isSelected(name)) return false;
+
+        qint64 iterations = 1;
+        QElapsedTimer timer;
+        while (true) {
+            timer.start();
+            for (qint64 i = 0; i < iterations; i++) body();
+            qint64 elapsed = timer.nsecsElapsed();
+            if (elapsed >= minBatchNs || iterations >= (qint64(1) << 40)) break;
+            // Aim slightly above the minimum batch time, growing at most a hundredfold per step
+            double scale = elapsed > 0 ? 1.2 * minBatchNs / elapsed : 100;
+            iterations = std::max(iterations + 1, (qint64) (iterations * std::min(scale, 100.0)));
+        }
+
+        QVector<double> perIteration;
+        for (int r = 0; r < repetitions; r++) {
+            timer.start();
+            for (qint64 i = 0; i < iterations; i++) body();
+            perIteration.append((double) timer.nsecsElapsed() / iterations);
+        }
+        record(name, params, iterations, perIteration);
+        return true;
+    }
+
+    void setCounter(const QString &key, double value);
+
+    QJsonObject toJson() const;
+    bool saveJson(const QString &fileName, const QJsonObject &context) const;
+
+    /**
+     * @brief keep Makes the compiler assume the value is used, so that the code computing it is not optimized away.
+     */
+    template<typename T>
+    static inline void keep(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &value;
+#endif
+    }
+
+private:
+    void record(const QString &name, const QJsonObject &params, qint64 iterations, QVector<double> &perIteration);
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,300 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QPair>
+#include <QTextStream>
+
+#include "benchmark.h"
+#include "../mathutility.h"
+#include "../scene.h"
+#include "../tools/cylinder.h"
+#include "../tools/drum.h"
+#include "../tools/sphere.h"
+
+namespace {
+
+const int NumPoints = 64;
+
+/**
+ * @brief The Kind enum lists the kinds of envelopes that are timed, which differ in how their path and axis are found.
+ */
+enum Kind {
+    Free,
+    TangentContinuous,
+    AxisConstrained
+};
+
+const char *kindName(Kind kind)
+{
+    switch (kind) {
+    case TangentContinuous: return "tangent";
+    case AxisConstrained: return "constrained";
+    default: return "free";
+    }
+}
+
+/**
+ * @brief describeScene Returns a scene whose last envelope is of the given kind, together with the envelopes it depends on.
+ */
+SceneDescription describeScene(Kind kind, int sectorsA, int sectorsT)
+{
+    SceneDescription description;
+    description.sectorsA = sectorsA;
+    description.sectorsT = sectorsT;
+
+    EnvelopeDescription first;
+    first.path[0][2] = 1;
+    first.axisA1 = QVector3D(0, 1, 0.2);
+    description.envelopes.append(first);
+
+    if (kind == TangentContinuous) {
+        EnvelopeDescription drum;
+        drum.toolType = Tool_Drum;
+        drum.adjacentA0 = 0;
+        drum.tangentContinuous = true;
+        drum.axisAngle1 = 10;
+        drum.axisAngle2 = 30;
+        description.envelopes.append(drum);
+    } else if (kind == AxisConstrained) {
+        EnvelopeDescription second;
+        second.path[0][3] = 1.5;
+        description.envelopes.append(second);
+        EnvelopeDescription constrained;
+        constrained.adjacentA0 = 0;
+        constrained.adjacentA1 = 1;
+        description.envelopes.append(constrained);
+    }
+    for (EnvelopeDescription &envDesc : description.envelopes) {
+        envDesc.sectorsA = sectorsA;
+        envDesc.sectorsT = sectorsT;
+    }
+    return description;
+}
+
+/**
+ * @brief loadScene Loads and computes a described scene. Exits if the scene is invalid, which would be a bug of describeScene.
+ */
+void loadScene(Scene &scene, const SceneDescription &description)
+{
+    QString error;
+    if (!scene.load(description, error)) {
+        qFatal("Invalid benchmark scene: %s", qPrintable(error));
+    }
+    scene.compute(false);
+}
+
+/**
+ * @brief points Returns (t,a) pairs spread over the parameter domain, so that point evaluations do not hit the same values every time.
+ */
+QVector<QVector2D> points()
+{
+    QVector<QVector2D> result;
+    for (int i = 0; i < NumPoints; i++) {
+        result.append(QVector2D((i * 37 % NumPoints + 0.5f) / NumPoints, (i * 11 % NumPoints + 0.5f) / NumPoints));
+    }
+    return result;
+}
+
+void benchmarkEvaluation(Benchmark &bench)
+{
+    using Function = QVector3D (Envelope::*)(float, float) const;
+    const QList<QPair<QString, Function>> functions = {
+        {"envelope/getEnvelopeAt", &Envelope::getEnvelopeAt},
+        {"envelope/getEnvelopeDtAt", &Envelope::getEnvelopeDtAt},
+        {"envelope/getEnvelopeDt2At", &Envelope::getEnvelopeDt2At},
+        {"envelope/getEnvelopeDt3At", &Envelope::getEnvelopeDt3At},
+        {"envelope/getNormalAt", &Envelope::getNormalAt},
+        {"envelope/getNormalDtAt", &Envelope::getNormalDtAt},
+        {"envelope/getNormalDt2At", &Envelope::getNormalDt2At},
+        {"envelope/getNormalDt3At", &Envelope::getNormalDt3At},
+    };
+    const QVector<QVector2D> ta = points();
+
+    for (Kind kind : {Free, TangentContinuous, AxisConstrained}) {
+        Scene scene;
+        loadScene(scene, describeScene(kind, 20, 50));
+        const Envelope *env = scene.getEnvelopes().last();
+        for (const auto &function : functions) {
+            int i = 0;
+            bench.run(function.first, {{"kind", kindName(kind)}}, [&]() {
+                const QVector2D &p = ta[i++ % NumPoints];
+                Benchmark::keep((env->*function.second)(p.x(), p.y()));
+            });
+        }
+    }
+}
+
+/**
+ * @brief benchmarkJets Times the jets of every order computed with the hand-derived formulas and by propagating Taylor series, on
+ * frames computed beforehand, which is how evaluateJet chooses between them. Order 0 always uses the series, so it is not compared.
+ */
+void benchmarkJets(Benchmark &bench)
+{
+    const QVector<QVector2D> ta = points();
+
+    for (Kind kind : {Free, TangentContinuous, AxisConstrained}) {
+        Scene scene;
+        loadScene(scene, describeScene(kind, 20, 50));
+        const Envelope *env = scene.getEnvelopes().last();
+        QVector<EnvelopeFrame> frames;
+        for (const QVector2D &p : ta) frames.append(env->computeFrameAt(p.x(), EnvelopeJet::MAX_ORDER + 1));
+
+        for (int order = 1; order <= EnvelopeJet::MAX_ORDER; order++) {
+            QJsonObject params = {{"kind", kindName(kind)}, {"order", order}};
+            int i = 0;
+            bench.run("envelope/evaluateJet", params, [&]() {
+                int k = i++ % NumPoints;
+                Benchmark::keep(env->evaluateJet(frames[k], ta[k].y(), order));
+            });
+            bench.run("envelope/evaluateJetTaylor", params, [&]() {
+                int k = i++ % NumPoints;
+                Benchmark::keep(env->evaluateJetTaylor(frames[k], ta[k].y(), order));
+            });
+        }
+    }
+}
+
+void benchmarkCompute(Benchmark &bench, const QList<QPair<int, int>> &sectors)
+{
+    for (Kind kind : {Free, TangentContinuous, AxisConstrained}) {
+        for (const auto &s : sectors) {
+            Scene scene;
+            loadScene(scene, describeScene(kind, s.first, s.second));
+            // Only the last envelope is recomputed, the ones it depends on keep their cached boundaries
+            Envelope *env = scene.getEnvelopes().last();
+            for (bool parallel : {false, true}) {
+                env->setParallel(parallel);
+                QJsonObject params = {{"kind", kindName(kind)}, {"sectorsA", s.first}, {"sectorsT", s.second}, {"parallel", parallel}};
+                bench.run("envelope/computeEnvelope", params, [&]() {
+                    env->update();
+                    Benchmark::keep(env->getVertexArr().constData());
+                });
+            }
+        }
+    }
+}
+
+void benchmarkNormalDerivatives(Benchmark &bench)
+{
+    // A vector and its derivatives along a smooth curve, so that the derivatives are of realistic size
+    QVector3D a[5] = {QVector3D(1, 0.5f, 0.25f), QVector3D(0.2f, -0.3f, 0.1f), QVector3D(-0.05f, 0.04f, 0.02f),
+                      QVector3D(0.01f, 0.003f, -0.002f), QVector3D(0.001f, -0.0005f, 0.0002f)};
+    bench.run("mathutility/normalVectorDerivative", {}, [&]() {
+        Benchmark::keep(MathUtility::normalVectorDerivative(a[0], a[1]));
+    });
+    bench.run("mathutility/normalVectorDerivative2", {}, [&]() {
+        Benchmark::keep(MathUtility::normalVectorDerivative2(a[0], a[1], a[2]));
+    });
+    bench.run("mathutility/normalVectorDerivative3", {}, [&]() {
+        Benchmark::keep(MathUtility::normalVectorDerivative3(a[0], a[1], a[2], a[3]));
+    });
+    bench.run("mathutility/normalVectorDerivative4", {}, [&]() {
+        Benchmark::keep(MathUtility::normalVectorDerivative4(a[0], a[1], a[2], a[3], a[4]));
+    });
+    for (int order : {2, 4}) {
+        QVector3D b[5];
+        bench.run("mathutility/normalVectorDerivatives", {{"order", order}}, [&]() {
+            MathUtility::normalVectorDerivatives(a, b, order);
+            Benchmark::keep(b);
+        });
+    }
+}
+
+void benchmarkProfiles(Benchmark &bench)
+{
+    Cylinder cylinder;
+    cylinder.setRadius(0.5);
+    cylinder.setAngle(0.2f);
+    Drum drum;
+    drum.setRadius(0.5);
+    drum.setCurvatureRadius(4);
+    QVector<float> as;
+    for (int i = 0; i < NumPoints; i++) as.append((i + 0.5f) / NumPoints);
+
+    for (const Tool *tool : {(const Tool*) &cylinder, (const Tool*) &drum}) {
+        QJsonObject params = {{"tool", tool == &drum ? "drum" : "cylinder"}};
+        int i = 0;
+        bench.run("tool/getRadiusAt", params, [&]() { Benchmark::keep(tool->getRadiusAt(as[i++ % NumPoints])); });
+        bench.run("tool/getRadiusDaAt", params, [&]() { Benchmark::keep(tool->getRadiusDaAt(as[i++ % NumPoints])); });
+        bench.run("tool/getSphereCenterHeightAt", params, [&]() { Benchmark::keep(tool->getSphereCenterHeightAt(as[i++ % NumPoints])); });
+        bench.run("tool/getSphereCenterHeightDaAt", params, [&]() { Benchmark::keep(tool->getSphereCenterHeightDaAt(as[i++ % NumPoints])); });
+        bench.run("tool/getSphereRadiusAt", params, [&]() { Benchmark::keep(tool->getSphereRadiusAt(as[i++ % NumPoints])); });
+        bench.run("tool/getSphereRadiusDaAt", params, [&]() { Benchmark::keep(tool->getSphereRadiusDaAt(as[i++ % NumPoints])); });
+        bench.run("tool/getToolSurfaceAt", params, [&]() {
+            float a = as[i++ % NumPoints];
+            Benchmark::keep(tool->getToolSurfaceAt(a, a * 6.28f));
+        });
+    }
+}
+
+void benchmarkMeshes(Benchmark &bench, const QList<int> &sectorCounts)
+{
+    for (int sectors : sectorCounts) {
+        Cylinder cylinder;
+        Drum drum;
+        for (Tool *tool : {(Tool*) &cylinder, (Tool*) &drum}) {
+            tool->setSectors(sectors);
+            bench.run("tool/computeTool", {{"tool", tool == &drum ? "drum" : "cylinder"}, {"sectors", sectors}}, [&]() {
+                tool->computeTool();
+                Benchmark::keep(tool->getVertexArr().constData());
+            });
+        }
+        Sphere sphere;
+        bench.run("sphere/generateVertexArr", {{"sectors", sectors}}, [&]() {
+            sphere.generateVertexArr(sectors, sectors);
+            Benchmark::keep(sphere.getVertexArr().constData());
+        });
+    }
+}
+
+}
+
+/**
+ * @brief main Entry point of the micro-benchmarks. Times point evaluations and mesh computations of envelopes, the derivatives of
+ * normalized vectors and the profiles and meshes of tools, over a range of sector counts. Prints every result and optionally writes
+ * all of them as JSON.
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("envelope_microbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times the geometry hot paths of the envelopes and tools.");
+    parser.addHelpOption();
+    QCommandLineOption jsonOption("json", "File to write the results to as JSON.", "file");
+    QCommandLineOption filterOption("filter", "Only run cases whose name contains this text.", "text");
+    QCommandLineOption minTimeOption("min-time", "Minimum time of every timed batch in milliseconds.", "ms", "20");
+    QCommandLineOption repetitionsOption("repetitions", "Number of timed batches per case.", "count", "5");
+    QCommandLineOption quickOption("quick", "Only use the smallest sector counts.");
+    parser.addOptions({jsonOption, filterOption, minTimeOption, repetitionsOption, quickOption});
+    parser.process(app);
+
+    Benchmark bench;
+    bench.setFilter(parser.value(filterOption));
+    bench.setMinBatchMs(parser.value(minTimeOption).toInt());
+    bench.setRepetitions(parser.value(repetitionsOption).toInt());
+
+    QList<QPair<int, int>> envelopeSectors = {{10, 25}, {20, 50}, {50, 100}, {100, 250}};
+    QList<int> toolSectors = {10, 20, 50, 100};
+    if (parser.isSet(quickOption)) {
+        envelopeSectors = envelopeSectors.mid(0, 2);
+        toolSectors = toolSectors.mid(0, 2);
+    }
+
+    benchmarkEvaluation(bench);
+    benchmarkJets(bench);
+    benchmarkCompute(bench, envelopeSectors);
+    benchmarkNormalDerivatives(bench);
+    benchmarkProfiles(bench);
+    benchmarkMeshes(bench, toolSectors);
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject context;
+        context["executable"] = QCoreApplication::applicationName();
+        context["min_time_ms"] = parser.value(minTimeOption).toInt();
+        if (!bench.saveJson(parser.value(jsonOption), context)) {
+            qCritical() << "Cannot write" << parser.value(jsonOption);
+            return 1;
+        }
+    }
+    return 0;
+}
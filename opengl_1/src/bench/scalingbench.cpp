@@ -0,0 +1,196 @@
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QPair>
+#include <QTextStream>
+
+#include "benchmark.h"
+#include "scenariogenerator.h"
+#include "../scene.h"
+
+namespace {
+
+const int NumPoints = 61;
+
+/**
+ * @brief residentBytes Returns the resident memory of the process, or -1 where it is not known. Only Linux reports it.
+ */
+double residentBytes()
+{
+    QFile file("/proc/self/status");
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    QTextStream in(&file);
+    QString line;
+    while (in.readLineInto(&line)) {
+        if (line.startsWith("VmRSS:")) {
+            return line.mid(6).trimmed().section(' ', 0, 0).toDouble() * 1024;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief meshBytes Returns the memory held by the meshes and sample grids of all envelopes of a scene.
+ */
+double meshBytes(const Scene &scene)
+{
+    double bytes = 0;
+    for (const Envelope *env : scene.getEnvelopes()) {
+        bytes += env->getVertexArr().size() * sizeof(EnvelopeVertex);
+        bytes += env->getIndexArr().size() * sizeof(unsigned int);
+        bytes += (env->getGridPositions().size() + env->getGridNormals().size()) * sizeof(QVector3D);
+    }
+    return bytes;
+}
+
+/**
+ * @brief isFinite Whether all sampled positions of all envelopes are finite. Generated scenes are meant to be valid geometry,
+ * as degenerate envelopes would be timed on code paths real scenes do not take.
+ */
+bool isFinite(const Scene &scene)
+{
+    for (const Envelope *env : scene.getEnvelopes()) {
+        for (const QVector3D &p : env->getGridPositions()) {
+            if (!std::isfinite(p.x()) || !std::isfinite(p.y()) || !std::isfinite(p.z())) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief benchmarkUpdate Times computing all envelopes of a scene, which is the latency of an edit to the envelopes every other one
+ * depends on. Attaches the size of the scene and the memory its meshes take.
+ */
+void benchmarkUpdate(Benchmark &bench, const QString &scenario, const SceneDescription &description, QJsonObject params, bool parallel)
+{
+    QString name = "scaling/update/" + scenario;
+    if (!bench.isSelected(name)) return;
+
+    double residentBefore = residentBytes();
+    Scene scene;
+    QString error;
+    if (!scene.load(description, error)) {
+        qFatal("Invalid generated scene: %s", qPrintable(error));
+    }
+    scene.compute(parallel);
+    if (!isFinite(scene)) {
+        qWarning().noquote() << name << ": the generated scene is degenerate";
+    }
+
+    params["sectorsA"] = description.sectorsA;
+    params["sectorsT"] = description.sectorsT;
+    params["parallel"] = parallel;
+    bench.run(name, params, [&]() {
+        scene.compute(parallel);
+        Benchmark::keep(scene.getEnvelopes().last()->getVertexArr().constData());
+    });
+
+    qsizetype numTriangles = 0;
+    for (const Envelope *env : scene.getEnvelopes()) numTriangles += env->getIndexArr().size() / 3;
+    bench.setCounter("envelopes", scene.getEnvelopes().size());
+    bench.setCounter("triangles", numTriangles);
+    bench.setCounter("mesh_bytes", meshBytes(scene));
+    double residentAfter = residentBytes();
+    if (residentBefore >= 0 && residentAfter >= 0) {
+        bench.setCounter("resident_bytes", residentAfter - residentBefore);
+    }
+}
+
+/**
+ * @brief benchmarkEvaluation Times evaluating the path, axis and surface of the last envelope of a chain at t between the rows of
+ * its grid, where no boundary sample of the envelopes it depends on is cached.
+ */
+void benchmarkEvaluation(Benchmark &bench, int depth)
+{
+    Scene scene;
+    QString error;
+    if (!scene.load(ScenarioGenerator::chains(1, depth, 20, 50), error)) {
+        qFatal("Invalid generated scene: %s", qPrintable(error));
+    }
+    scene.compute(false);
+    const Envelope *env = scene.getEnvelopes().last();
+
+    QVector<float> ts;
+    for (int i = 0; i < NumPoints; i++) ts.append((i + 0.37f) / NumPoints);
+    QJsonObject params = {{"depth", depth}};
+    int i = 0;
+    bench.run("scaling/getPathAt", params, [&]() { Benchmark::keep(env->getPathAt(ts[i++ % NumPoints])); });
+    bench.run("scaling/getAxisAt", params, [&]() { Benchmark::keep(env->getAxisAt(ts[i++ % NumPoints])); });
+    bench.run("scaling/getEnvelopeAt", params, [&]() { Benchmark::keep(env->getEnvelopeAt(ts[i++ % NumPoints], 0.5f)); });
+}
+
+QList<int> parseList(const QString &text)
+{
+    QList<int> values;
+    for (const QString &value : text.split(',')) {
+        bool ok;
+        int n = value.toInt(&ok);
+        if (ok && n > 0) values.append(n);
+    }
+    return values;
+}
+
+}
+
+/**
+ * @brief main Entry point of the scaling benchmark. Times updating generated scenes as the number of envelopes, the depth of chains
+ * of tangent continuous envelopes and the sector counts grow, and the evaluation of the deepest envelope of chains. Prints every result
+ * and optionally writes all of them as JSON.
+ */
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("envelope_scalingbench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times updating generated scenes of growing size.");
+    parser.addHelpOption();
+    QCommandLineOption jsonOption("json", "File to write the results to as JSON.", "file");
+    QCommandLineOption filterOption("filter", "Only run cases whose name contains this text.", "text");
+    QCommandLineOption minTimeOption("min-time", "Minimum time of every timed batch in milliseconds.", "ms", "50");
+    QCommandLineOption repetitionsOption("repetitions", "Number of timed batches per case.", "count", "3");
+    QCommandLineOption countsOption("counts", "Comma separated numbers of independent envelopes and bridges.", "list", "1,2,4,8,16,32");
+    QCommandLineOption depthsOption("depths", "Comma separated depths of chains.", "list", "1,2,3,4,6,8,12");
+    QCommandLineOption sectorsOption("sectors", "Comma separated sectors in a, sectorsT is two and a half times as many.", "list", "10,20,40,80");
+    QCommandLineOption serialOption("serial", "Compute every scene on one thread.");
+    parser.addOptions({jsonOption, filterOption, minTimeOption, repetitionsOption, countsOption, depthsOption, sectorsOption, serialOption});
+    parser.process(app);
+
+    Benchmark bench;
+    bench.setFilter(parser.value(filterOption));
+    bench.setMinBatchMs(parser.value(minTimeOption).toInt());
+    bench.setRepetitions(parser.value(repetitionsOption).toInt());
+    bool parallel = !parser.isSet(serialOption);
+    QList<int> counts = parseList(parser.value(countsOption));
+    QList<int> depths = parseList(parser.value(depthsOption));
+    QList<int> sectors = parseList(parser.value(sectorsOption));
+
+    for (int count : counts) {
+        benchmarkUpdate(bench, "independent", ScenarioGenerator::chains(count, 1, 20, 50), {{"count", count}}, parallel);
+    }
+    for (int depth : depths) {
+        benchmarkUpdate(bench, "chain", ScenarioGenerator::chains(1, depth, 20, 50), {{"depth", depth}}, parallel);
+    }
+    for (int count : counts) {
+        benchmarkUpdate(bench, "bridges", ScenarioGenerator::bridges(count, 20, 50), {{"count", count}}, parallel);
+    }
+    // A short chain at growing resolution
+    for (int sectorsA : sectors) {
+        int sectorsT = sectorsA * 5 / 2;
+        benchmarkUpdate(bench, "sectors", ScenarioGenerator::chains(1, 3, sectorsA, sectorsT), {{"depth", 3}}, parallel);
+    }
+    for (int depth : depths) {
+        benchmarkEvaluation(bench, depth);
+    }
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject context;
+        context["executable"] = QCoreApplication::applicationName();
+        context["min_time_ms"] = parser.value(minTimeOption).toInt();
+        context["parallel"] = parallel;
+        if (!bench.saveJson(parser.value(jsonOption), context)) {
+            qCritical() << "Cannot write" << parser.value(jsonOption);
+            return 1;
+        }
+    }
+    return 0;
+}
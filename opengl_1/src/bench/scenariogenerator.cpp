@@ -0,0 +1,82 @@
+#include "scenariogenerator.h"
+
+namespace {
+// Distance between neighbouring chains or bridges along x
+const float Spacing = 4;
+}
+
+/**
+ * @brief ScenarioGenerator::freeCylinder Returns a cylinder moving along a straight path in the xz plane that starts at x,
+ * while its axis tilts slightly.
+ */
+EnvelopeDescription ScenarioGenerator::freeCylinder(float x, int sectorsA, int sectorsT)
+{
+    EnvelopeDescription envDesc;
+    envDesc.path[0][2] = 1;
+    envDesc.path[0][3] = x;
+    envDesc.path[2][2] = 1;
+    envDesc.axisA0 = QVector3D(0, 1, 0);
+    envDesc.axisA1 = QVector3D(0, 1, 0.2);
+    envDesc.sectorsA = sectorsA;
+    envDesc.sectorsT = sectorsT;
+    return envDesc;
+}
+
+/**
+ * @brief ScenarioGenerator::chains Returns a scene of independent chains of tangent continuous envelopes.
+ * @param count Number of chains.
+ * @param depth Number of envelopes per chain, including the free cylinder it starts with.
+ */
+SceneDescription ScenarioGenerator::chains(int count, int depth, int sectorsA, int sectorsT)
+{
+    SceneDescription description;
+    description.sectorsA = sectorsA;
+    description.sectorsT = sectorsT;
+    for (int c = 0; c < count; c++) {
+        description.envelopes.append(freeCylinder(c * Spacing, sectorsA, sectorsT));
+        for (int d = 1; d < depth; d++) {
+            EnvelopeDescription envDesc;
+            if (d % 2 == 1) {
+                envDesc.toolType = Tool_Drum;
+                envDesc.radius = 0.4;
+                envDesc.curvatureRadius = 4;
+            } else {
+                envDesc.radius = 0.3;
+                envDesc.angle = 0.1;
+            }
+            envDesc.height = 1;
+            envDesc.adjacentA0 = description.envelopes.size() - 1;
+            envDesc.tangentContinuous = true;
+            // The axes turn back and forth, as turning the same way every time curls long chains up until their envelopes degenerate
+            envDesc.axisAngle1 = d % 2 == 1 ? 10 : -10;
+            envDesc.axisAngle2 = d % 2 == 1 ? 20 : -20;
+            envDesc.sectorsA = sectorsA;
+            envDesc.sectorsT = sectorsT;
+            description.envelopes.append(envDesc);
+        }
+    }
+    return description;
+}
+
+/**
+ * @brief ScenarioGenerator::bridges Returns a scene of axis constrained envelopes, each spanning between two free cylinders of its own.
+ * @param count Number of bridges, the scene has three times as many envelopes.
+ */
+SceneDescription ScenarioGenerator::bridges(int count, int sectorsA, int sectorsT)
+{
+    SceneDescription description;
+    description.sectorsA = sectorsA;
+    description.sectorsT = sectorsT;
+    for (int b = 0; b < count; b++) {
+        int first = description.envelopes.size();
+        description.envelopes.append(freeCylinder(b * Spacing, sectorsA, sectorsT));
+        description.envelopes.append(freeCylinder(b * Spacing + 1.5f, sectorsA, sectorsT));
+        EnvelopeDescription envDesc;
+        envDesc.adjacentA0 = first;
+        envDesc.adjacentA1 = first + 1;
+        envDesc.sectorsA = sectorsA;
+        envDesc.sectorsT = sectorsT;
+        description.envelopes.append(envDesc);
+    }
+    return description;
+}
@@ -0,0 +1,22 @@
+#ifndef SCENARIOGENERATOR_H
+#define SCENARIOGENERATOR_H
+
+#include "../scenedescription.h"
+
+/**
+ * @brief The ScenarioGenerator class builds scenes of configurable size for benchmarks.
+ * Scenes consist of chains, which start with a free cylinder followed by envelopes that are each tangent continuous to the previous
+ * one, alternating between drums and cylinders, or of bridges, which are axis constrained envelopes between two free cylinders.
+ * Chains and bridges are placed side by side, so that they do not intersect. Chains of depth 1 are independent envelopes.
+ */
+class ScenarioGenerator
+{
+public:
+    static SceneDescription chains(int count, int depth, int sectorsA, int sectorsT);
+    static SceneDescription bridges(int count, int sectorsA, int sectorsT);
+
+private:
+    static EnvelopeDescription freeCylinder(float x, int sectorsA, int sectorsT);
+};
+
+#endif // SCENARIOGENERATOR_H
@@ -0,0 +1,75 @@
+#ifndef BOUNDARYCURVE_H
+#define BOUNDARYCURVE_H
+
+#include <QMutex>
+#include <QVector>
+#include <QVector3D>
+#include "envelopeframe.h"
+
+/**
+ * @brief The BoundarySample struct holds the position and the normal of an envelope on one of its boundaries, a=0 or a=1,
+ * together with their t-derivatives up to the given order. The axis is kept as well, up to one order higher,
+ * since tangent continuous dependents rotate it.
+ */
+struct BoundarySample {
+    static constexpr int MAX_ORDER = EnvelopeFrame::MAX_ORDER - 1;
+
+    float t = 0;
+    int order = -1;
+
+    QVector3D position[MAX_ORDER + 1];
+    QVector3D normal[MAX_ORDER + 1];
+    QVector3D axis[MAX_ORDER + 2];
+};
+
+/**
+ * @brief The BoundaryCurve class caches samples of one boundary of an envelope at the t of its grid rows.
+ * Samples are filled on demand and stay valid until the envelope is invalidated.
+ * The curve may be read and filled from several threads at once.
+ */
+class BoundaryCurve {
+    int sectorsT = 0;
+    QVector<BoundarySample> samples;
+    mutable QMutex mutex;
+
+public:
+    inline void invalidate() {
+        QMutexLocker locker(&mutex);
+        samples.clear();
+    }
+
+    /**
+     * @brief find Looks up the sample at t, if t lies on a grid row and that sample is known up to the given order.
+     * @return True if the sample was cached and copied to sample.
+     */
+    inline bool find(float t, int order, BoundarySample &sample) const {
+        QMutexLocker locker(&mutex);
+        if (samples.isEmpty()) return false;
+        int tIdx = rowOf(t);
+        if (tIdx < 0 || samples[tIdx].order < order) return false;
+        sample = samples[tIdx];
+        return true;
+    }
+
+    /**
+     * @brief store Keeps the sample if its t lies on a grid row with sectorsT sectors.
+     */
+    inline void store(const BoundarySample &sample, int sectorsT) {
+        QMutexLocker locker(&mutex);
+        if (samples.isEmpty() || this->sectorsT != sectorsT) {
+            this->sectorsT = sectorsT;
+            samples = QVector<BoundarySample>(sectorsT + 1);
+        }
+        int tIdx = rowOf(sample.t);
+        if (tIdx >= 0 && samples[tIdx].order < sample.order) samples[tIdx] = sample;
+    }
+
+private:
+    inline int rowOf(float t) const {
+        int tIdx = qRound(t * sectorsT);
+        if (tIdx < 0 || tIdx > sectorsT || (float) tIdx / sectorsT != t) return -1;
+        return tIdx;
+    }
+};
+
+#endif // BOUNDARYCURVE_H
@@ -1,5 +1,10 @@
 #include "envelope.h"
+#include "logging.h"
 #include "mathutility.h"
+#include "profiler.h"
+#include "taylor.h"
+#include "taskpool.h"
+#include "adaptivetessellator.h"
 
 /**
  * @brief Envelope::Envelope Creates a new envelope with default values.
@@ -49,30 +54,81 @@ Envelope::Envelope(int index, Tool *tool, const SimplePath &path, Envelope *adjE
  */
 void Envelope::initEnvelope()
 {
-    computeEnvelope();
-    computeToolCenters();
-    computeGrazingCurves();
-    computeNormals();
+    prepareRows();
+    computeRows();
+    finishRows();
     active = true;
 }
 
 void Envelope::update() {
-    computeEnvelope();
-    computeToolCenters();
-    computeGrazingCurves();
-    computeNormals();
+    invalidateBoundaries();
+    prepareRows();
+    computeRows();
+    finishRows();
+}
+
+/**
+ * @brief Envelope::copyDefinition Copies everything the geometry of the envelope depends on from another envelope, but none of its meshes.
+ * The copy may belong to another set of envelopes, in which each envelope has the same index as its original.
+ * Boundaries cached for the previous definition are dropped.
+ * @param other Envelope to copy.
+ * @param tool Tool to use instead of the tool of other.
+ * @param envelopes Set of envelopes the adjacent and dependent envelopes are taken from.
+ */
+void Envelope::copyDefinition(const Envelope &other, Tool *tool, const QVector<Envelope*> &envelopes)
+{
+    this->tool = tool;
+    toolMovement = other.toolMovement;
+    active = other.active;
+    adjEnvA0 = other.adjEnvA0 != nullptr ? envelopes[other.adjEnvA0->index] : nullptr;
+    adjEnvA1 = other.adjEnvA1 != nullptr ? envelopes[other.adjEnvA1->index] : nullptr;
+    dependentEnvelopes.clear();
+    for (const Envelope *dependent : other.dependentEnvelopes) {
+        dependentEnvelopes.append(envelopes[dependent->index]);
+    }
+    tanContToAdj = other.tanContToAdj;
+    adjAxisAngle1 = other.adjAxisAngle1;
+    adjAxisAngle2 = other.adjAxisAngle2;
+    sectorsA = other.sectorsA;
+    sectorsT = other.sectorsT;
+    parallel = other.parallel;
+    tolerance = other.tolerance;
+    angleTolerance = other.angleTolerance;
+    invalidateBoundaries();
+}
+
+/**
+ * @brief Envelope::adoptMeshes Takes over the meshes of an envelope that was computed from a copy of this one.
+ * The arrays are swapped, so computed is left with the previous meshes to overwrite next time.
+ */
+void Envelope::adoptMeshes(Envelope &computed)
+{
+    std::swap(gridSectorsA, computed.gridSectorsA);
+    std::swap(gridSectorsT, computed.gridSectorsT);
+    gridPositions.swap(computed.gridPositions);
+    gridNormals.swap(computed.gridNormals);
+    rowPaths.swap(computed.rowPaths);
+    rowAxes.swap(computed.rowAxes);
+    vertexArr.swap(computed.vertexArr);
+    indexArr.swap(computed.indexArr);
+    vertexParams.swap(computed.vertexParams);
+    toolMovement.getPathVertexArr().swap(computed.toolMovement.getPathVertexArr());
+
+    centersValid = false;
+    grazingCurveValid = false;
+    normalsTIdx = -1;
 }
 
 void Envelope::registerDependent(Envelope *dependent) {
     // TODO check for circular dependencies when adding
     if (dependentEnvelopes.contains(dependent)) return;
     dependentEnvelopes.append(dependent);
-    qDebug() << "Added dependent";
+    qCDebug(lcCompute) << "Added dependent";
 }
 
 void Envelope::deregisterDependent(Envelope *dependent) {
     qsizetype num = dependentEnvelopes.removeAll(dependent);
-    qDebug() << "Removed" << num << "dependents";
+    qCDebug(lcCompute) << "Removed" << num << "dependents";
 }
 
 /**
@@ -112,6 +168,23 @@ QSet<int> Envelope::getAllDependents() {
     return dependencySet;
 }
 
+/**
+ * @brief Envelope::invalidateBoundaries Drops the cached boundaries of this envelope and of all envelopes that depend on it.
+ */
+void Envelope::invalidateBoundaries() {
+    QVector<Envelope*> queue;
+    QSet<Envelope*> visited;
+    queue.append(this);
+    while (queue.size() > 0) {
+        Envelope *env = queue.takeFirst();
+        if (visited.contains(env)) continue;
+        visited += env;
+        env->boundaryA0.invalidate();
+        env->boundaryA1.invalidate();
+        queue += env->dependentEnvelopes;
+    }
+}
+
 void Envelope::setAdjacentA0Envelope(Envelope *env){
     if (adjEnvA0 != nullptr) this->adjEnvA0->deregisterDependent(this);
     adjEnvA0 = env;
@@ -125,403 +198,481 @@ void Envelope::setAdjacentA1Envelope(Envelope *env){
 }
 
 /**
- * @brief Envelope::computeEnvelope Computes the vertex array of the envelope.
+ * @brief Envelope::forEachRow Calls rowFunction for every t row 0..sectorsT, concurrently on the shared task pool if the envelope is parallel.
+ * Each call must only write to the parts of the output that belong to its own row.
  */
-void Envelope::computeEnvelope()
+void Envelope::forEachRow(const std::function<void(int)> &rowFunction) const
 {
-    vertexArr.clear();
+    if (!parallel) {
+        for (int tIdx = 0; tIdx <= sectorsT; tIdx++) rowFunction(tIdx);
+        return;
+    }
+    TaskPool::instance()->parallelFor(0, sectorsT + 1, rowFunction, 1, "envelope row");
+}
 
-    QVector3D env[4];
-    QVector3D norm[4];
-    QVector3D col[4];
-    // SimplePath path = toolMovement->getPath();
-    // float aDelta = (tool->getA1()-tool->getA0())/sectorsA;
-    // float a1 = tool->getA1()-aDelta;
-    // float tDelta = (path.getT1()-path.getT0())/sectorsT;
-    // float t1 = path.getT1()-tDelta;
-    for (int tIdx = 0; tIdx < sectorsT; tIdx++)
+/**
+ * @brief Envelope::computeRows Computes all rows, timed as a whole so that the profiler is not locked once per row.
+ */
+void Envelope::computeRows()
+{
+    ProfileScope scope("envelope/computeRows");
+    forEachRow([this](int tIdx) { computeRow(tIdx); });
+}
+
+/**
+ * @brief Envelope::prepareRows Sizes all vertex arrays for the current sectors, so that rows can then be computed in any order,
+ * and drops the debug overlays. The arrays are detached here, as computeRow may write to them from several threads at once.
+ */
+void Envelope::prepareRows()
+{
+    ProfileScope scope("envelope/prepareRows");
+    gridSectorsA = sectorsA;
+    gridSectorsT = sectorsT;
+    int numNodes = (sectorsT + 1) * (sectorsA + 1);
+
+    // The adaptive mesh samples the envelope where it needs to, so the grid is only sampled for the overlays that read it
+    if (tolerance > 0) {
+        gridPositions.clear();
+        gridNormals.clear();
+    } else {
+        gridPositions.resize(numNodes);
+        gridPositions.detach();
+        gridNormals.resize(numNodes);
+        gridNormals.detach();
+        vertexArr.resize(numNodes);
+        vertexArr.detach();
+        indexArr.resize(6 * sectorsT * sectorsA);
+        indexArr.detach();
+        vertexParams.clear();
+    }
+
+    rowPaths.resize(sectorsT + 1);
+    rowPaths.detach();
+    rowAxes.resize(sectorsT + 1);
+    rowAxes.detach();
+    QVector<Vertex>& pathArr = toolMovement.getPathVertexArr();
+    pathArr.resize(sectorsT + 1);
+    pathArr.detach();
+
+    centersValid = false;
+    grazingCurveValid = false;
+    normalsTIdx = -1;
+}
+
+/**
+ * @brief Envelope::computeRow Computes the mesh and the path for the t row tIdx, and keeps the path and axis of the row for the debug overlays.
+ * Different rows may be computed concurrently once prepareRows has been called.
+ * @param tIdx Index of the row, 0 to sectorsT.
+ */
+void Envelope::computeRow(int tIdx)
+{
+    float t = (float) tIdx / sectorsT;
+    EnvelopeFrame frame = computeFrameAt(t, 1);
+
+    if (tolerance <= 0) {
+        sampleGridRow(tIdx, frame);
+        computeEnvelopeRow(tIdx);
+    }
+
+    rowPaths[tIdx] = frame.path[0];
+    rowAxes[tIdx] = frame.axis[0];
+    toolMovement.getPathVertexArr()[tIdx] = Vertex(frame.path[0], QVector3D(0,0,1));
+}
+
+/**
+ * @brief Envelope::publishBoundaries Caches the boundaries at the t of row tIdx that the dependents of this envelope read for their row at the same t.
+ * @param tIdx Index of the row, 0 to sectorsT.
+ */
+void Envelope::publishBoundaries(int tIdx) const
+{
+    float t = (float) tIdx / sectorsT;
+    for (const Envelope *dependent : dependentEnvelopes) {
+        if (dependent->adjEnvA0 == this) getBoundaryAt(t, 1, dependent->getAdjacentOrder(1));
+        if (dependent->adjEnvA1 == this) getBoundaryAt(t, 0, 2);
+    }
+}
+
+/**
+ * @brief Envelope::finishRows Replaces the uniform mesh by an adaptive one if a tolerance is set. Must be called once all rows are computed.
+ */
+void Envelope::finishRows()
+{
+    if (tolerance <= 0) return;
+    ProfileScope scope("envelope/tessellate");
+    AdaptiveTessellator(*this, tolerance, angleTolerance).tessellate(vertexArr, indexArr, &vertexParams);
+}
+
+/**
+ * @brief Envelope::getVertexParamsAt Gives the (t,a) parameters of vertex i of the mesh.
+ */
+QVector2D Envelope::getVertexParamsAt(int i) const
+{
+    if (!vertexParams.isEmpty()) return vertexParams[i];
+    return QVector2D((float) (i / (gridSectorsA + 1)) / gridSectorsT, (float) (i % (gridSectorsA + 1)) / gridSectorsA);
+}
+
+/**
+ * @brief Envelope::sampleGrid Samples the grid if the adaptive mesh left it out. Does nothing if the grid is sampled already.
+ */
+void Envelope::sampleGrid()
+{
+    int numNodes = (gridSectorsT + 1) * (gridSectorsA + 1);
+    if (gridSectorsT < 1 || gridSectorsA < 1 || gridPositions.size() == numNodes) return;
+    ProfileScope scope("envelope/sampleGrid");
+    gridPositions.resize(numNodes);
+    gridNormals.resize(numNodes);
+    for (int tIdx = 0; tIdx <= gridSectorsT; tIdx++) {
+        sampleGridRow(tIdx, computeFrameAt((float) tIdx / gridSectorsT, 1));
+    }
+}
+
+/**
+ * @brief Envelope::sampleGridRow Evaluates the position and normal of the envelope once at every (t,a) node of the row.
+ */
+void Envelope::sampleGridRow(int tIdx, const EnvelopeFrame &frame)
+{
+    for (int aIdx = 0; aIdx <= gridSectorsA; aIdx++)
     {
-        for (int aIdx = 0; aIdx < sectorsA; aIdx++)
-        {
-            float tDelta = 1.0f/sectorsT;
-            float aDelta = 1.0f/sectorsA;
-
-            float t = (float) tIdx / sectorsT;
-            float a = (float) aIdx / sectorsA;
-
-            env[0] = getEnvelopeAt(t, a);
-            env[1] = getEnvelopeAt(t, a+aDelta);
-            env[2] = getEnvelopeAt(t+tDelta, a);
-            env[3] = getEnvelopeAt(t+tDelta, a+aDelta);
-
-            norm[0] = getNormalAt(t, a);
-            norm[1] = getNormalAt(t, a+aDelta);
-            norm[2] = getNormalAt(t+tDelta, a);
-            norm[3] = getNormalAt(t+tDelta, a+aDelta);
-
-            for (int i = 0; i < 4; i++) {
-                if (reflectionLines){
-                    float alpha;
-                    alpha = acos(QVector3D::dotProduct(norm[i],QVector3D(1,0,0)));
-                    float aux = alpha * reflFreq;
-                    if (aux -(int)aux <= percentBlack)
-                        col[i] = QVector3D(0,0,0);
-                    else
-                        col[i] = QVector3D(1,1,1);
-                } else {
-                    col[i] = norm[i];
-                }
-            }
+        float a = (float) aIdx / gridSectorsA;
+
+        EnvelopeJet jet = evaluateJet(frame, a, 0);
+        gridNormals[gridIndex(tIdx, aIdx)] = jet.normal[0];
+        gridPositions[gridIndex(tIdx, aIdx)] = jet.position[0];
+    }
+}
 
-            Vertex v1{env[0], col[0]};
-            Vertex v2{env[1], col[1]};
-            Vertex v3{env[2], col[2]};
-            Vertex v4{env[3], col[3]};
+/**
+ * @brief Envelope::computeEnvelopeRow Computes the vertices of the row, and the triangles between it and the next row.
+ */
+void Envelope::computeEnvelopeRow(int tIdx)
+{
+    for (int aIdx = 0; aIdx <= sectorsA; aIdx++)
+    {
+        int i = gridIndex(tIdx, aIdx);
+        vertexArr[i] = EnvelopeVertex(gridPositions[i], gridNormals[i]);
+    }
 
-            // Add vertices to array
-            vertexArr.append(v1);
-            vertexArr.append(v4);
-            vertexArr.append(v2);
-            vertexArr.append(v1);
-            vertexArr.append(v3);
-            vertexArr.append(v4);
-        }
+    if (tIdx == sectorsT) return;
+    for (int aIdx = 0; aIdx < sectorsA; aIdx++)
+    {
+        unsigned int i1 = gridIndex(tIdx, aIdx);
+        unsigned int i2 = gridIndex(tIdx, aIdx+1);
+        unsigned int i3 = gridIndex(tIdx+1, aIdx);
+        unsigned int i4 = gridIndex(tIdx+1, aIdx+1);
+
+        // Add triangles to array
+        unsigned int *quad = indexArr.data() + 6 * (tIdx * sectorsA + aIdx);
+        quad[0] = i1;
+        quad[1] = i4;
+        quad[2] = i2;
+        quad[3] = i1;
+        quad[4] = i3;
+        quad[5] = i4;
     }
 }
 
+QVector3D Envelope::getEnvelopeAt(float t, float a) const
+{
+    return getEnvelopeAt(computeFrameAt(t, 1), a);
+}
+
+QVector3D Envelope::getEnvelopeDtAt(float t, float a) const
+{
+    return getEnvelopeDtAt(computeFrameAt(t, 2), a);
+}
+
+QVector3D Envelope::getEnvelopeDt2At(float t, float a) const
+{
+    return getEnvelopeDt2At(computeFrameAt(t, 3), a);
+}
+
+QVector3D Envelope::getEnvelopeDt3At(float t, float a) const
+{
+    return getEnvelopeDt3At(computeFrameAt(t, 4), a);
+}
 
-QVector3D Envelope::getEnvelopeAt(float t, float a)
+QVector3D Envelope::getEnvelopeAt(const EnvelopeFrame &frame, float a) const
 {
-    return getPathAt(t) + tool->getSphereCenterHeightAt(a) * getAxisAt(t) + tool->getSphereRadiusAt(a) * getNormalAt(t, a);
+    return evaluateJet(frame, a, 0).position[0];
 }
 
-QVector3D Envelope::getEnvelopeDtAt(float t, float a)
+QVector3D Envelope::getEnvelopeDtAt(const EnvelopeFrame &frame, float a) const
 {
-    return getPathDtAt(t) + tool->getSphereCenterHeightAt(a) * getAxisDtAt(t) + tool->getSphereRadiusAt(a) * getNormalDtAt(t, a);
+    return evaluateJet(frame, a, 1).position[1];
 }
 
-QVector3D Envelope::getEnvelopeDt2At(float t, float a)
+QVector3D Envelope::getEnvelopeDt2At(const EnvelopeFrame &frame, float a) const
 {
-    return getPathDt2At(t) + tool->getSphereCenterHeightAt(a) * getAxisDt2At(t) + tool->getSphereRadiusAt(a) * getNormalDt2At(t, a);
+    return evaluateJet(frame, a, 2).position[2];
 }
 
-QVector3D Envelope::getEnvelopeDt3At(float t, float a)
+QVector3D Envelope::getEnvelopeDt3At(const EnvelopeFrame &frame, float a) const
+{
+    return evaluateJet(frame, a, 3).position[3];
+}
+
+
+/**
+ * @brief Envelope::getVertexArrCenters Gives the vertex array of the tool axes, computing it if the geometry changed since.
+ */
+QVector<Vertex>& Envelope::getVertexArrCenters()
+{
+    if (!centersValid) computeToolCenters();
+    return vertexArrCenters;
+}
+
+/**
+ * @brief Envelope::getVertexArrGrazingCurve Gives the vertex array of the grazing curves, computing it if the geometry changed since.
+ */
+QVector<Vertex>& Envelope::getVertexArrGrazingCurve()
 {
-    return getPathDt3At(t) + tool->getSphereCenterHeightAt(a) * getAxisDt3At(t) + tool->getSphereRadiusAt(a) * getNormalDt3At(t, a);
+    if (!grazingCurveValid) computeGrazingCurves();
+    return vertexArrGrazingCurve;
 }
 
+/**
+ * @brief Envelope::getVertexArrNormalsAt Gives the vertex array of the normals of a row of the sampled grid. Only the last requested row is kept.
+ * @param gridRow Row of the grid, see getGridRowAt.
+ */
+QVector<Vertex>& Envelope::getVertexArrNormalsAt(int gridRow)
+{
+    if (normalsTIdx != gridRow) computeNormals(gridRow);
+    return vertexArrNormals;
+}
 
 /**
  * @brief Envelope::computeToolCenters Computes the vertex array of tool centers.
  */
 void Envelope::computeToolCenters()
 {
-    vertexArrCenters.clear();
-    QVector<Vertex>& pathArr = toolMovement.getPathVertexArr();
-    pathArr.clear();
+    ProfileScope scope("envelope/computeToolCenters");
+    vertexArrCenters.resize(2 * rowPaths.size());
 
     QVector3D color = QVector3D(0,0,1);
 
-    QVector3D v1, v2;
-    // SimplePath path = toolMovement.getPath();
-    // float aDelta = (tool->getA1()-tool->getA0())/sectorsA;
-    // float a1 = tool->getA1()-aDelta;
-    // float tDelta = (path.getT1()-path.getT0())/sectorsT;
-    // float t1 = path.getT1();
-    for (int tIdx = 0; tIdx <= sectorsT; tIdx++)
+    for (int tIdx = 0; tIdx < rowPaths.size(); tIdx++)
     {
-        float tDelta = 1.0f/sectorsT;
-
-        float t = (float) tIdx / sectorsT;
-
-        v1 = getPathAt(t);
-        v2 = getPathAt(t) + tool->getHeight() * getAxisAt(t);
+        QVector3D v1 = rowPaths[tIdx];
+        QVector3D v2 = rowPaths[tIdx] + tool->getHeight() * rowAxes[tIdx];
 
         // Add vertices to array
-        vertexArrCenters.append(Vertex(v1, color));
-        vertexArrCenters.append(Vertex(v2, color));
-
-        pathArr.append(Vertex(v1, color));
+        vertexArrCenters[2*tIdx] = Vertex(v1, color);
+        vertexArrCenters[2*tIdx+1] = Vertex(v2, color);
     }
+    centersValid = true;
 }
 
 /**
- * @brief Envelope::computeGrazingCurves Computes the vertex array of the grazing curves.
+ * @brief Envelope::computeGrazingCurves Computes the vertex array of the grazing curves from the sampled grid.
  */
 void Envelope::computeGrazingCurves()
 {
-    vertexArrGrazingCurve.clear();
+    ProfileScope scope("envelope/computeGrazingCurves");
+    sampleGrid();
+    vertexArrGrazingCurve.resize(2 * (gridSectorsT + 1) * gridSectorsA);
 
     QVector3D color = QVector3D(0,1,0);
 
-    QVector3D v1, v2;
-    // SimplePath path = toolMovement->getPath();
-    // float aDelta = (tool->getA1()-tool->getA0())/sectorsA;
-    // float a1 = tool->getA1()-aDelta;
-    // float tDelta = (path.getT1()-path.getT0())/sectorsT;
-    // float t1 = path.getT1();
-    for (int tIdx = 0; tIdx <= sectorsT; tIdx++)
+    for (int tIdx = 0; tIdx <= gridSectorsT; tIdx++)
     {
-        for (int aIdx = 0; aIdx < sectorsA; aIdx++)
+        for (int aIdx = 0; aIdx < gridSectorsA; aIdx++)
         {
-            float aDelta = 1.0f/sectorsA;
-
-            float t = (float) tIdx / sectorsT;
-            float a = (float) aIdx / sectorsA;
-
-            v1 = getEnvelopeAt(t, a);
-            v2 = getEnvelopeAt(t, a+aDelta);
-
             // Add vertices to array
-            vertexArrGrazingCurve.append(Vertex(v1, color));
-            vertexArrGrazingCurve.append(Vertex(v2, color));
+            Vertex *segment = vertexArrGrazingCurve.data() + 2 * (tIdx * gridSectorsA + aIdx);
+            segment[0] = Vertex(gridPositions[gridIndex(tIdx, aIdx)], color);
+            segment[1] = Vertex(gridPositions[gridIndex(tIdx, aIdx+1)], color);
         }
     }
+    grazingCurveValid = true;
 }
 
 /**
- * @brief Envelope::computeNormals Computes the vertex array of the normals.
+ * @brief Envelope::computeNormals Computes the vertex array of the normals of row tIdx of the sampled grid, which is empty if there is no such row.
  */
-void Envelope::computeNormals(){
+void Envelope::computeNormals(int tIdx)
+{
+    ProfileScope scope("envelope/computeNormals");
     vertexArrNormals.clear();
+    normalsTIdx = tIdx;
+    if (tIdx < 0 || tIdx >= rowPaths.size()) return;
 
     QVector3D c = QVector3D(0,1,0);
 
-    QVector3D v1, p1;
-    QVector<Vertex> normals;
-    for (int tIdx = 0; tIdx <= sectorsT; tIdx++)
+    // Only this row is evaluated if the adaptive mesh left the grid out
+    bool sampled = !gridPositions.isEmpty();
+    EnvelopeFrame frame;
+    if (!sampled) frame = computeFrameAt((float) tIdx / gridSectorsT, 1);
+
+    vertexArrNormals.resize(2 * (gridSectorsA + 1));
+    for (int aIdx = 0; aIdx <= gridSectorsA; aIdx++)
     {
-        normals.clear();
-        for (int aIdx = 0; aIdx <= sectorsA; aIdx++)
-        {
-            float t = (float) tIdx / sectorsT;
-            float a = (float) aIdx / sectorsA;
-            p1 = getPathAt(t) + tool->getSphereCenterHeightAt(a)*getAxisAt(t);
-            v1 = getEnvelopeAt(t, a);
+        float a = (float) aIdx / gridSectorsA;
+        QVector3D p1 = rowPaths[tIdx] + tool->getSphereCenterHeightAt(a)*rowAxes[tIdx];
+        QVector3D v1 = sampled ? gridPositions[gridIndex(tIdx, aIdx)] : evaluateJet(frame, a, 0).position[0];
 
-            // Add vertices to array
-            normals.append(Vertex(p1,c));
-            normals.append(Vertex(v1,c));
-        }
-        vertexArrNormals.append(normals);
+        // Add vertices to array
+        vertexArrNormals[2*aIdx] = Vertex(p1,c);
+        vertexArrNormals[2*aIdx+1] = Vertex(v1,c);
     }
 }
 
-QVector3D Envelope::getNormalAt(float t, float a)
+QVector3D Envelope::getNormalAt(float t, float a) const
 {
-    QVector3D sa = tool->getSphereCenterHeightDaAt(a) * getAxisAt(t);
-    QVector3D st = getPathDtAt(t) + tool->getSphereCenterHeightAt(a) * getAxisDtAt(t);
-    QVector3D sNormal = QVector3D::crossProduct(sa, st).normalized();
-
-    float ra = tool->getSphereRadiusDaAt(a);
-
-    float E = QVector3D::dotProduct(sa, sa);
-    float F = QVector3D::dotProduct(sa, st);
-    float G = QVector3D::dotProduct(st, st);
-    float EG_FF = E * G - F * F;
-
-    float m11 = G / EG_FF;
-    float m21 = -F / EG_FF;
-
-    float alpha = -m11 * ra;
-    float beta = -m21 * ra;
-
-    float sqrt_term = 1 - ra * ra * m11;
-    float gamma = (EG_FF > 0 ? 1 : -1) * sqrt(sqrt_term);
-
-    QVector3D n = alpha * sa + beta * st + gamma * sNormal;
-    return n.normalized();
+    return getNormalAt(computeFrameAt(t, 1), a);
 }
 
-QVector3D Envelope::getNormalDtAt(float t, float a)
+QVector3D Envelope::getNormalDtAt(float t, float a) const
 {
-    QVector3D sa = tool->getSphereCenterHeightDaAt(a) * getAxisAt(t);
-    QVector3D sat = tool->getSphereCenterHeightDaAt(a) * getAxisDtAt(t);
-    QVector3D st = getPathDtAt(t) + tool->getSphereCenterHeightAt(a) * getAxisDtAt(t);
-    QVector3D stt = getPathDt2At(t) + tool->getSphereCenterHeightAt(a) * getAxisDt2At(t);
-    QVector3D sNormal = QVector3D::crossProduct(sa, st).normalized();
-    QVector3D sNormal_t = MathUtility::normalVectorDerivative(QVector3D::crossProduct(sa, st), QVector3D::crossProduct(sat, st) + QVector3D::crossProduct(sa, stt));
-
-    float ra = tool->getSphereRadiusDaAt(a);
-
-    float E = QVector3D::dotProduct(sa, sa);
-    float Et = 2 * QVector3D::dotProduct(sa, sat);
-    float F = QVector3D::dotProduct(sa, st);
-    float Ft = QVector3D::dotProduct(sat, st) + QVector3D::dotProduct(sa, stt);
-    float G = QVector3D::dotProduct(st, st);
-    float Gt = 2 * QVector3D::dotProduct(st, stt);
-    float EG_FF = E * G - F * F;
-    float EG_FF_t = Et * G + E * Gt - 2 * F * Ft;
-
-    float m11 = G / EG_FF;
-    float m11_t = (EG_FF * Gt - G * EG_FF_t) / (EG_FF * EG_FF);
-
-    float m21 = -F / EG_FF;
-    float m21_t = -(EG_FF * Ft - F * EG_FF_t) / (EG_FF * EG_FF);
-
-    float alpha = -m11 * ra;
-    float alpha_t = -m11_t * ra;
-
-    float beta = -m21 * ra;
-    float beta_t = -m21_t * ra;
-
-    float sqrt_term = 1 - ra * ra * m11;
-    float gamma = (EG_FF > 0 ? 1 : -1) * sqrt(sqrt_term);
-    float gamma_t = (EG_FF > 0 ? 1 : -1) * -ra * ra * m11_t / (2 * sqrt(sqrt_term));
+    return getNormalDtAt(computeFrameAt(t, 2), a);
+}
 
-    QVector3D n = alpha * sa + beta * st + gamma * sNormal;
-    QVector3D nt = alpha * sat + alpha_t * sa + beta * stt + beta_t * st + gamma * sNormal_t + gamma_t * sNormal;
-    return MathUtility::normalVectorDerivative(n, nt);
+QVector3D Envelope::getNormalDt2At(float t, float a) const
+{
+    return getNormalDt2At(computeFrameAt(t, 3), a);
 }
 
-QVector3D Envelope::getNormalDt2At(float t, float a)
+QVector3D Envelope::getNormalDt3At(float t, float a) const
 {
-    QVector3D sa = tool->getSphereCenterHeightDaAt(a) * getAxisAt(t);
-    QVector3D sat = tool->getSphereCenterHeightDaAt(a) * getAxisDtAt(t);
-    QVector3D satt = tool->getSphereCenterHeightDaAt(a) * getAxisDt2At(t);
-    QVector3D st = getPathDtAt(t) + tool->getSphereCenterHeightAt(a) * getAxisDtAt(t);
-    QVector3D stt = getPathDt2At(t) + tool->getSphereCenterHeightAt(a) * getAxisDt2At(t);
-    QVector3D sttt = getPathDt3At(t) + tool->getSphereCenterHeightAt(a) * getAxisDt3At(t);
-    QVector3D sNormal = QVector3D::crossProduct(sa, st);
-    QVector3D sNormal_t = QVector3D::crossProduct(sat, st) + QVector3D::crossProduct(sa, stt);
-    QVector3D sNormal_tt = QVector3D::crossProduct(satt, st) + QVector3D::crossProduct(sat, stt) + QVector3D::crossProduct(sat, stt) + QVector3D::crossProduct(sa, sttt);
-    sNormal_tt = MathUtility::normalVectorDerivative2(sNormal, sNormal_t, sNormal_tt);
-    sNormal_t = MathUtility::normalVectorDerivative(sNormal, sNormal_t);
-    sNormal.normalize();
+    return getNormalDt3At(computeFrameAt(t, 4), a);
+}
 
-    float ra = tool->getSphereRadiusDaAt(a);
+QVector3D Envelope::getNormalAt(const EnvelopeFrame &frame, float a) const
+{
+    return evaluateJet(frame, a, 0).normal[0];
+}
 
-    float E = QVector3D::dotProduct(sa, sa);
-    float Et = 2 * QVector3D::dotProduct(sa, sat);
-    float Ett = 2 * QVector3D::dotProduct(sat, sat) + 2 * QVector3D::dotProduct(sa, satt);
-    float F = QVector3D::dotProduct(sa, st);
-    float Ft = QVector3D::dotProduct(sat, st) + QVector3D::dotProduct(sa, stt);
-    float Ftt = QVector3D::dotProduct(satt, st) + 2 * QVector3D::dotProduct(sat, stt) + QVector3D::dotProduct(sa, sttt);
-    float G = QVector3D::dotProduct(st, st);
-    float Gt = 2 * QVector3D::dotProduct(st, stt);
-    float Gtt = 2 * QVector3D::dotProduct(stt, stt) + 2 * QVector3D::dotProduct(st, sttt);
-    float EG_FF = E * G - F * F;
-    float EG_FF_2 = EG_FF * EG_FF;
-    float EG_FF_3 = EG_FF * EG_FF * EG_FF;
-    float EG_FF_t = Et * G + E * Gt - 2 * F * Ft;
-    float EG_FF_tt = Ett * G + 2 * Et * Gt + E * Gtt - 2 * (Ft * Ft + F * Ftt);
+QVector3D Envelope::getNormalDtAt(const EnvelopeFrame &frame, float a) const
+{
+    return evaluateJet(frame, a, 1).normal[1];
+}
 
-    float m11 = G / EG_FF;
-    float m11_t = (EG_FF * Gt - G * EG_FF_t) / EG_FF_2;
-    float m11_tt = (Gtt * EG_FF_2 -
-                    2 * Gt * EG_FF * EG_FF_t -
-                    G * EG_FF * EG_FF_tt +
-                    2 * G * EG_FF_t * EG_FF_t) / EG_FF_3;
+QVector3D Envelope::getNormalDt2At(const EnvelopeFrame &frame, float a) const
+{
+    return evaluateJet(frame, a, 2).normal[2];
+}
 
-    float m21 = -F / EG_FF;
-    float m21_t = -(EG_FF * Ft - F * EG_FF_t) / EG_FF_2;
-    float m21_tt = -(Ftt * EG_FF_2 -
-                     2 * Ft * EG_FF * EG_FF_t -
-                     F * EG_FF * EG_FF_tt +
-                     2 * F * EG_FF_t * EG_FF_t) / EG_FF_3;
+QVector3D Envelope::getNormalDt3At(const EnvelopeFrame &frame, float a) const
+{
+    return evaluateJet(frame, a, 3).normal[3];
+}
 
-    float alpha = -m11 * ra;
-    float alpha_t = -m11_t * ra;
-    float alpha_tt = -m11_tt * ra;
+/**
+ * @brief Envelope::evaluateJet Computes the position and the normal of the envelope, and their t-derivatives up to the given order, at (t,a).
+ * @param t Time.
+ * @param a Position along the tool.
+ * @param order Highest derivative, at most EnvelopeJet::MAX_ORDER.
+ * @return
+ */
+EnvelopeJet Envelope::evaluateJet(float t, float a, int order) const
+{
+    return evaluateJet(computeFrameAt(t, order + 1), a, order);
+}
 
-    float beta = -m21 * ra;
-    float beta_t = -m21_t * ra;
-    float beta_tt = -m21_tt * ra;
+/**
+ * @brief Envelope::evaluateJet Computes the position and the normal of the envelope, and their t-derivatives up to the given order, at (frame.t,a).
+ * All orders are computed in one pass, so the terms of the lower orders are shared instead of rebuilt for every derivative.
+ * @param frame Frame of the envelope at t, of at least order + 1.
+ * @param a Position along the tool.
+ * @param order Highest derivative, at most EnvelopeJet::MAX_ORDER.
+ * @return
+ */
+EnvelopeJet Envelope::evaluateJet(const EnvelopeFrame &frame, float a, int order) const
+{
+    // Propagating Taylor series is faster for the plain position and normal, the hand-derived formulas are faster for the derivatives
+    if (order == 0) return evaluateJetTaylor<0>(frame, a);
 
-    float sqrt_term = 1 - ra * ra * m11;
-    float gamma = (EG_FF > 0 ? 1 : -1) * sqrt(sqrt_term);
-    float gamma_t = (EG_FF > 0 ? 1 : -1) * -ra * ra * m11_t / (2 * sqrt(sqrt_term));
-    float gamma_tt = (EG_FF > 0 ? 1 : -1) *
-                     -ra * ra / 2 *
-                     (m11_tt / sqrt(sqrt_term) +
-                      (ra * ra * m11_t * m11_t) / (2 * pow(sqrt_term, 1.5f)));
-
-    QVector3D n = alpha * sa +
-                beta * st +
-                gamma * sNormal;
-    QVector3D nt = alpha * sat + alpha_t * sa +
-                 beta * stt + beta_t * st +
-                 gamma * sNormal_t + gamma_t * sNormal;
-    QVector3D ntt = alpha * satt +
-                  2 * alpha_t * sat +
-                  alpha_tt * sa +
-                  beta * sttt +
-                  2 * beta_t * stt +
-                  beta_tt * st +
-                  gamma * sNormal_tt +
-                  2 * +gamma_t * sNormal_t +
-                  gamma_tt * sNormal;
-    return MathUtility::normalVectorDerivative2(n, nt, ntt);
-}
-
-QVector3D Envelope::getNormalDt3At(float t, float a)
-{
-    QVector3D sa = tool->getSphereCenterHeightDaAt(a) * getAxisAt(t);
-    QVector3D sat = tool->getSphereCenterHeightDaAt(a) * getAxisDtAt(t);
-    QVector3D satt = tool->getSphereCenterHeightDaAt(a) * getAxisDt2At(t);
-    QVector3D sattt = tool->getSphereCenterHeightDaAt(a) * getAxisDt3At(t);
-    QVector3D st = getPathDtAt(t) + tool->getSphereCenterHeightAt(a) * getAxisDtAt(t);
-    QVector3D stt = getPathDt2At(t) + tool->getSphereCenterHeightAt(a) * getAxisDt2At(t);
-    QVector3D sttt = getPathDt3At(t) + tool->getSphereCenterHeightAt(a) * getAxisDt3At(t);
-    QVector3D stttt = getPathDt4At(t) + tool->getSphereCenterHeightAt(a) * getAxisDt4At(t);
-    QVector3D sNormal = QVector3D::crossProduct(sa, st);
-    QVector3D sNormal_t = QVector3D::crossProduct(sat, st) + QVector3D::crossProduct(sa, stt);
-    QVector3D sNormal_tt = QVector3D::crossProduct(satt, st) + 2 * QVector3D::crossProduct(sat, stt) + QVector3D::crossProduct(sa, sttt);
-    QVector3D sNormal_ttt = QVector3D::crossProduct(sattt, st) + 3 * QVector3D::crossProduct(satt, stt) + 3 * QVector3D::crossProduct(sat, sttt) + QVector3D::crossProduct(sa, stttt);
-    sNormal_ttt = MathUtility::normalVectorDerivative3(sNormal, sNormal_t, sNormal_tt, sNormal_ttt);
-    sNormal_tt = MathUtility::normalVectorDerivative2(sNormal, sNormal_t, sNormal_tt);
-    sNormal_t = MathUtility::normalVectorDerivative(sNormal, sNormal_t);
-    sNormal.normalize();
+    EnvelopeJet jet;
+    jet.t = frame.t;
+    jet.a = a;
+    jet.order = order;
 
+    float h = tool->getSphereCenterHeightAt(a);
+    float ha = tool->getSphereCenterHeightDaAt(a);
+    float r = tool->getSphereRadiusAt(a);
     float ra = tool->getSphereRadiusDaAt(a);
 
-    float E = QVector3D::dotProduct(sa, sa);
-    float Et = 2 * QVector3D::dotProduct(sa, sat);
-    float Ett = 2 * QVector3D::dotProduct(sat, sat) + 2 * QVector3D::dotProduct(sa, satt);
-    float Ettt = 6 * QVector3D::dotProduct(sat, satt) + 2 * QVector3D::dotProduct(sa, sattt);
-    float F = QVector3D::dotProduct(sa, st);
-    float Ft = QVector3D::dotProduct(sat, st) + QVector3D::dotProduct(sa, stt);
-    float Ftt = QVector3D::dotProduct(satt, st) + 2 * QVector3D::dotProduct(sat, stt) + QVector3D::dotProduct(sa, sttt);
-    float Fttt = QVector3D::dotProduct(sattt, st) + 3 * QVector3D::dotProduct(satt, stt) + 3 * QVector3D::dotProduct(sat, sttt) + QVector3D::dotProduct(sa, stttt);
-    float G = QVector3D::dotProduct(st, st);
-    float Gt = 2 * QVector3D::dotProduct(st, stt);
-    float Gtt = 2 * QVector3D::dotProduct(stt, stt) + 2 * QVector3D::dotProduct(st, sttt);
-    float Gttt = 6 * QVector3D::dotProduct(stt, sttt) + 2 * QVector3D::dotProduct(st, stttt);
+    // Derivatives of the sphere center surface, index k holds the k-th t-derivative
+    QVector3D sa[EnvelopeJet::MAX_ORDER + 1];
+    QVector3D st[EnvelopeJet::MAX_ORDER + 1];
+    for (int k = 0; k <= order; k++) {
+        sa[k] = ha * frame.axis[k];
+        st[k] = frame.path[k + 1] + h * frame.axis[k + 1];
+    }
+
+    // Unit normal of the sphere center surface and its derivatives
+    QVector3D sNormal[EnvelopeJet::MAX_ORDER + 1];
+    QVector3D sCross[EnvelopeJet::MAX_ORDER + 1];
+    sCross[0] = QVector3D::crossProduct(sa[0], st[0]);
+    if (order >= 1) sCross[1] = QVector3D::crossProduct(sa[1], st[0]) + QVector3D::crossProduct(sa[0], st[1]);
+    if (order >= 2) sCross[2] = QVector3D::crossProduct(sa[2], st[0]) + 2 * QVector3D::crossProduct(sa[1], st[1]) + QVector3D::crossProduct(sa[0], st[2]);
+    if (order >= 3) sCross[3] = QVector3D::crossProduct(sa[3], st[0]) + 3 * QVector3D::crossProduct(sa[2], st[1]) + 3 * QVector3D::crossProduct(sa[1], st[2]) + QVector3D::crossProduct(sa[0], st[3]);
+    MathUtility::normalVectorDerivatives(sCross, sNormal, order);
+
+    float E = QVector3D::dotProduct(sa[0], sa[0]);
+    float F = QVector3D::dotProduct(sa[0], st[0]);
+    float G = QVector3D::dotProduct(st[0], st[0]);
     float EG_FF = E * G - F * F;
     float EG_FF_2 = EG_FF * EG_FF;
-    float EG_FF_3 = EG_FF * EG_FF * EG_FF;
+    float EG_FF_3 = EG_FF_2 * EG_FF;
     float EG_FF_4 = EG_FF_2 * EG_FF_2;
-    float EG_FF_t = Et * G + E * Gt - 2 * F * Ft;
-    float EG_FF_tt = Ett * G + 2 * Et * Gt + E * Gtt - 2 * (Ft * Ft + F * Ftt);
-    float EG_FF_ttt = Ettt * G + 3 * Ett * Gt + 3 * Et * Gtt + E * Gttt - 2 * (3 * Ft * Ftt + F * Fttt);
 
-    float m11 = G / EG_FF;
-    float m11_t = (EG_FF * Gt - G * EG_FF_t) / EG_FF_2;
-    float m11_tt = (Gtt * EG_FF_2 -
-                    2 * Gt * EG_FF * EG_FF_t -
-                    G * EG_FF * EG_FF_tt +
-                    2 * G * EG_FF_t * EG_FF_t) / EG_FF_3;
-    float m11_ttt = (Gttt * EG_FF_3 -
-                     3 * EG_FF_2 * Gtt * EG_FF_t -
-                     3 * EG_FF_2 * Gt * EG_FF_tt +
-                     6 * EG_FF * Gt * EG_FF_t * EG_FF_t -
-                     G * EG_FF_ttt * EG_FF_2 -
-                     6 * G * EG_FF_t * EG_FF_t * EG_FF_t +
-                     6 * G * EG_FF * EG_FF_t * EG_FF_tt) / EG_FF_4;
+    float Et = 0, Ett = 0, Ettt = 0;
+    float Ft = 0, Ftt = 0, Fttt = 0;
+    float Gt = 0, Gtt = 0, Gttt = 0;
+    float EG_FF_t = 0, EG_FF_tt = 0, EG_FF_ttt = 0;
+    if (order >= 1) {
+        Et = 2 * QVector3D::dotProduct(sa[0], sa[1]);
+        Ft = QVector3D::dotProduct(sa[1], st[0]) + QVector3D::dotProduct(sa[0], st[1]);
+        Gt = 2 * QVector3D::dotProduct(st[0], st[1]);
+        EG_FF_t = Et * G + E * Gt - 2 * F * Ft;
+    }
+    if (order >= 2) {
+        Ett = 2 * QVector3D::dotProduct(sa[1], sa[1]) + 2 * QVector3D::dotProduct(sa[0], sa[2]);
+        Ftt = QVector3D::dotProduct(sa[2], st[0]) + 2 * QVector3D::dotProduct(sa[1], st[1]) + QVector3D::dotProduct(sa[0], st[2]);
+        Gtt = 2 * QVector3D::dotProduct(st[1], st[1]) + 2 * QVector3D::dotProduct(st[0], st[2]);
+        EG_FF_tt = Ett * G + 2 * Et * Gt + E * Gtt - 2 * (Ft * Ft + F * Ftt);
+    }
+    if (order >= 3) {
+        Ettt = 6 * QVector3D::dotProduct(sa[1], sa[2]) + 2 * QVector3D::dotProduct(sa[0], sa[3]);
+        Fttt = QVector3D::dotProduct(sa[3], st[0]) + 3 * QVector3D::dotProduct(sa[2], st[1]) + 3 * QVector3D::dotProduct(sa[1], st[2]) + QVector3D::dotProduct(sa[0], st[3]);
+        Gttt = 6 * QVector3D::dotProduct(st[1], st[2]) + 2 * QVector3D::dotProduct(st[0], st[3]);
+        EG_FF_ttt = Ettt * G + 3 * Ett * Gt + 3 * Et * Gtt + E * Gttt - 2 * (3 * Ft * Ftt + F * Fttt);
+    }
 
+    float m11 = G / EG_FF;
     float m21 = -F / EG_FF;
-    float m21_t = -(EG_FF * Ft - F * EG_FF_t) / EG_FF_2;
-    float m21_tt = -(Ftt * EG_FF_2 -
-                     2 * Ft * EG_FF * EG_FF_t -
-                     F * EG_FF * EG_FF_tt +
-                     2 * F * EG_FF_t * EG_FF_t) / EG_FF_3;
-    float m21_ttt = -(Fttt * EG_FF_3 -
-                      3 * EG_FF_2 * Ftt * EG_FF_t -
-                      3 * EG_FF_2 * Ft * EG_FF_tt +
-                      6 * EG_FF * Ft * EG_FF_t * EG_FF_t -
-                      F * EG_FF_ttt * EG_FF_2 -
-                      6 * F * EG_FF_t * EG_FF_t * EG_FF_t +
-                      6 * F * EG_FF * EG_FF_t * EG_FF_tt) / EG_FF_4;
+    float m11_t = 0, m11_tt = 0, m11_ttt = 0;
+    float m21_t = 0, m21_tt = 0, m21_ttt = 0;
+    if (order >= 1) {
+        m11_t = (EG_FF * Gt - G * EG_FF_t) / EG_FF_2;
+        m21_t = -(EG_FF * Ft - F * EG_FF_t) / EG_FF_2;
+    }
+    if (order >= 2) {
+        m11_tt = (Gtt * EG_FF_2 -
+                  2 * Gt * EG_FF * EG_FF_t -
+                  G * EG_FF * EG_FF_tt +
+                  2 * G * EG_FF_t * EG_FF_t) / EG_FF_3;
+        m21_tt = -(Ftt * EG_FF_2 -
+                   2 * Ft * EG_FF * EG_FF_t -
+                   F * EG_FF * EG_FF_tt +
+                   2 * F * EG_FF_t * EG_FF_t) / EG_FF_3;
+    }
+    if (order >= 3) {
+        m11_ttt = (Gttt * EG_FF_3 -
+                   3 * EG_FF_2 * Gtt * EG_FF_t -
+                   3 * EG_FF_2 * Gt * EG_FF_tt +
+                   6 * EG_FF * Gt * EG_FF_t * EG_FF_t -
+                   G * EG_FF_ttt * EG_FF_2 -
+                   6 * G * EG_FF_t * EG_FF_t * EG_FF_t +
+                   6 * G * EG_FF * EG_FF_t * EG_FF_tt) / EG_FF_4;
+        m21_ttt = -(Fttt * EG_FF_3 -
+                    3 * EG_FF_2 * Ftt * EG_FF_t -
+                    3 * EG_FF_2 * Ft * EG_FF_tt +
+                    6 * EG_FF * Ft * EG_FF_t * EG_FF_t -
+                    F * EG_FF_ttt * EG_FF_2 -
+                    6 * F * EG_FF_t * EG_FF_t * EG_FF_t +
+                    6 * F * EG_FF * EG_FF_t * EG_FF_tt) / EG_FF_4;
+    }
 
     float alpha = -m11 * ra;
     float alpha_t = -m11_t * ra;
@@ -533,224 +684,441 @@ QVector3D Envelope::getNormalDt3At(float t, float a)
     float beta_tt = -m21_tt * ra;
     float beta_ttt = -m21_ttt * ra;
 
+    float sign = EG_FF > 0 ? 1 : -1;
     float sqrt_term = 1 - ra * ra * m11;
-    float gamma = (EG_FF > 0 ? 1 : -1) * sqrt(sqrt_term);
-    float gamma_t = (EG_FF > 0 ? 1 : -1) * -ra * ra * m11_t / (2 * sqrt(sqrt_term));
-    float gamma_tt = (EG_FF > 0 ? 1 : -1) *
-                     -ra * ra / 2 *
-                     (m11_tt / sqrt(sqrt_term) +
-                      (ra * ra * m11_t * m11_t) / (2 * pow(sqrt_term, 1.5f)));
-    float gamma_ttt = (EG_FF > 0 ? 1 : -1) *
-                      -ra * ra / 2 *
-                      ((m11_ttt * sqrt(sqrt_term) + (ra * ra * m11_t * m11_tt) / (2 * sqrt(sqrt_term))) / (sqrt_term) +
-                       (ra * ra * m11_t * m11_tt * sqrt_term + 1.5f * pow(ra, 4) * pow(m11_t, 3)) / (pow(sqrt_term, 2.5f)));
-
-    QVector3D n = alpha * sa +
-                beta * st +
-                gamma * sNormal;
-    QVector3D nt = alpha * sat + alpha_t * sa +
-                 beta * stt + beta_t * st +
-                 gamma * sNormal_t + gamma_t * sNormal;
-    QVector3D ntt = alpha * satt +
-                  2 * alpha_t * sat +
-                  alpha_tt * sa +
-                  beta * sttt +
-                  2 * beta_t * stt +
-                  beta_tt * st +
-                  gamma * sNormal_tt +
-                  2 * gamma_t * sNormal_t +
-                  gamma_tt * sNormal;
-    QVector3D nttt = alpha * sattt +
-                   3 * alpha_t * satt +
-                   3 * alpha_tt * sat +
-                   alpha_ttt * sa +
-                   beta * stttt +
-                   3 * beta_t * sttt +
-                   3 * beta_tt * stt +
-                   beta_ttt * st +
-                   gamma * sNormal_ttt +
-                   3 * gamma_t * sNormal_tt +
-                   3 * gamma_tt * sNormal_t +
-                   gamma_ttt * sNormal;
-    return MathUtility::normalVectorDerivative3(n, nt, ntt, nttt);
-}
-
-
-
-QVector3D Envelope::getPathAt(float t)
-{
-    if (isTanContinuous())
-    {
-        return adjEnvA0->getEnvelopeAt(t, 1) - tool->getSphereRadiusAt(0) * adjEnvA0->getNormalAt(t, 1) - tool->getSphereCenterHeightAt(0) * getAxisAt(t);
+    float sqrt_value = sqrt(sqrt_term);
+    float gamma = sign * sqrt_value;
+    float gamma_t = 0, gamma_tt = 0, gamma_ttt = 0;
+    if (order >= 1) gamma_t = sign * -ra * ra * m11_t / (2 * sqrt_value);
+    if (order >= 2) gamma_tt = sign *
+                               -ra * ra / 2 *
+                               (m11_tt / sqrt_value +
+                                (ra * ra * m11_t * m11_t) / (2 * pow(sqrt_term, 1.5f)));
+    if (order >= 3) gamma_ttt = sign *
+                                -ra * ra / 2 *
+                                ((m11_ttt * sqrt_value + (ra * ra * m11_t * m11_tt) / (2 * sqrt_value)) / (sqrt_term) +
+                                 (ra * ra * m11_t * m11_tt * sqrt_term + 1.5f * pow(ra, 4) * pow(m11_t, 3)) / (pow(sqrt_term, 2.5f)));
+
+    // Unnormalized normal and its derivatives
+    QVector3D n[EnvelopeJet::MAX_ORDER + 1];
+    n[0] = alpha * sa[0] +
+           beta * st[0] +
+           gamma * sNormal[0];
+    if (order >= 1) n[1] = alpha * sa[1] + alpha_t * sa[0] +
+                           beta * st[1] + beta_t * st[0] +
+                           gamma * sNormal[1] + gamma_t * sNormal[0];
+    if (order >= 2) n[2] = alpha * sa[2] +
+                           2 * alpha_t * sa[1] +
+                           alpha_tt * sa[0] +
+                           beta * st[2] +
+                           2 * beta_t * st[1] +
+                           beta_tt * st[0] +
+                           gamma * sNormal[2] +
+                           2 * gamma_t * sNormal[1] +
+                           gamma_tt * sNormal[0];
+    if (order >= 3) n[3] = alpha * sa[3] +
+                           3 * alpha_t * sa[2] +
+                           3 * alpha_tt * sa[1] +
+                           alpha_ttt * sa[0] +
+                           beta * st[3] +
+                           3 * beta_t * st[2] +
+                           3 * beta_tt * st[1] +
+                           beta_ttt * st[0] +
+                           gamma * sNormal[3] +
+                           3 * gamma_t * sNormal[2] +
+                           3 * gamma_tt * sNormal[1] +
+                           gamma_ttt * sNormal[0];
+    MathUtility::normalVectorDerivatives(n, jet.normal, order);
+
+    for (int k = 0; k <= order; k++) {
+        jet.position[k] = frame.path[k] + h * frame.axis[k] + r * jet.normal[k];
     }
-    else if (isPositContinuous())
-    {
-        // The normal is orthogonal to X_t of the adjacent envelope, and at an angle to the axis of its own envelope.
-        // Thus start with the cross product of these two, and rotate it a certain amount around X_t of the adjacent.
-        QVector3D adjEnv = adjEnvA0->getEnvelopeAt(t, 1);
-        QVector3D adjEnv_t = adjEnvA0->getEnvelopeDtAt(t, 1);
-        QVector3D axis = getAxisAt(t);
-        float dotValue = -tool->getSphereRadiusDaAt(0) / tool->getSphereCenterHeightDaAt(0);
+    return jet;
+}
 
-        // MATH
-        QVector3D v = adjEnv_t.normalized();
-        QVector3D p = QVector3D(0,1,0);
-        if (p == v) p = QVector3D(1,0,0);
-        QVector3D w1 = (p - QVector3D::dotProduct(p, v) * v).normalized();
-        QVector3D w2 = QVector3D::crossProduct(v, w1);
-        float a_dot_w1 = QVector3D::dotProduct(axis, w1);
-        float a_dot_w2 = QVector3D::dotProduct(axis, w2);
 
-        float phi = atan2(a_dot_w2, a_dot_w1);
-        float theta = phi - acos(dotValue / sqrt(a_dot_w1 * a_dot_w1 + a_dot_w2 * a_dot_w2));
+/**
+ * @brief Envelope::evaluateJetTaylor Computes the same jet as evaluateJet, by propagating truncated Taylor series of order N
+ * through the expression of the normal instead of through hand-derived derivative formulas.
+ * @param frame Frame of the envelope at t, of at least order N + 1.
+ * @param a Position along the tool.
+ * @return
+ */
+template<int N>
+EnvelopeJet Envelope::evaluateJetTaylor(const EnvelopeFrame &frame, float a) const
+{
+    using Scalar = Taylor<float, N>;
+    using Vector = TaylorVector3D<N>;
 
-        QVector3D normal = w1 * cos(theta) + w2 * sin(theta);
+    float h = tool->getSphereCenterHeightAt(a);
+    float ha = tool->getSphereCenterHeightDaAt(a);
+    float r = tool->getSphereRadiusAt(a);
+    float ra = tool->getSphereRadiusDaAt(a);
 
-        return adjEnv - tool->getSphereRadiusAt(0) * normal - tool->getSphereCenterHeightAt(0) * axis;
-    }
-    else
-    {
-        return toolMovement.getPath().getPathAt(t);
+    Vector path = Vector::fromDerivatives(frame.path);
+    Vector axis = Vector::fromDerivatives(frame.axis);
+    // s_t is itself a t-derivative, so its series starts at the first derivatives of the frame
+    Vector st = Vector::fromDerivatives(frame.path + 1) + h * Vector::fromDerivatives(frame.axis + 1);
+    Vector sa = ha * axis;
+    Vector sNormal = Vector::crossProduct(sa, st).normalized();
+
+    Scalar E = Vector::dotProduct(sa, sa);
+    Scalar F = Vector::dotProduct(sa, st);
+    Scalar G = Vector::dotProduct(st, st);
+    Scalar EG_FF = E * G - F * F;
+
+    Scalar m11 = G / EG_FF;
+    Scalar m21 = -F / EG_FF;
+
+    Scalar alpha = -ra * m11;
+    Scalar beta = -ra * m21;
+    Scalar gamma = (EG_FF.value() > 0 ? 1.0f : -1.0f) * sqrt(1.0f - ra * ra * m11);
+
+    Vector normal = (alpha * sa + beta * st + gamma * sNormal).normalized();
+    Vector position = path + h * axis + r * normal;
+
+    EnvelopeJet jet;
+    jet.t = frame.t;
+    jet.a = a;
+    jet.order = N;
+    normal.derivatives(jet.normal);
+    position.derivatives(jet.position);
+    return jet;
+}
+
+/**
+ * @brief Envelope::evaluateJetTaylor Computes the same jet as evaluateJet by propagating Taylor series, for every order.
+ * evaluateJet only uses the series for order 0, the other orders are kept so the benchmarks can compare both ways.
+ * @param frame Frame of the envelope at t, of at least order + 1.
+ * @param a Position along the tool.
+ * @param order Highest derivative, at most EnvelopeJet::MAX_ORDER.
+ * @return
+ */
+EnvelopeJet Envelope::evaluateJetTaylor(const EnvelopeFrame &frame, float a, int order) const
+{
+    switch (order) {
+    case 0: return evaluateJetTaylor<0>(frame, a);
+    case 1: return evaluateJetTaylor<1>(frame, a);
+    case 2: return evaluateJetTaylor<2>(frame, a);
+    default: return evaluateJetTaylor<3>(frame, a);
     }
 }
 
-QVector3D Envelope::getPathDtAt(float t)
+/**
+ * @brief Envelope::computeFrameAt Computes the path and the axis, and their t-derivatives up to the given order, at time t.
+ * Dependent envelopes evaluate the frame of their adjacent envelope only once, instead of once for every quantity they need from it.
+ * @param t Time.
+ * @param order Highest derivative to compute, at most EnvelopeFrame::MAX_ORDER.
+ * @return
+ */
+EnvelopeFrame Envelope::computeFrameAt(float t, int order) const
 {
-    if (isTanContinuous())
+    EnvelopeFrame frame;
+    frame.t = t;
+    frame.order = order;
+
+    // Derivatives of the boundary a=1 of the adjacent envelope, as far as they are needed for this frame.
+    BoundarySample adjBoundary;
+    if (isPositContinuous())
     {
-        return adjEnvA0->getEnvelopeDtAt(t, 1) - tool->getSphereRadiusAt(0) * adjEnvA0->getNormalDtAt(t, 1) - tool->getSphereCenterHeightAt(0) * getAxisDtAt(t);
+        // The tangent continuous case also rotates the axis of the adjacent envelope, which the sample holds up to one order higher.
+        adjBoundary = adjEnvA0->getBoundaryAt(t, 1, getAdjacentOrder(order));
     }
-    else if (isPositContinuous())
+    const QVector3D *adjEnv = adjBoundary.position;
+    const QVector3D *adjNormal = adjBoundary.normal;
+
+    // Axis
+    if (isAxisConstrained())
+    {
+        BoundarySample adjBoundaryA1 = adjEnvA1->getBoundaryAt(t, 0, 2);
+
+        frame.axis[0] = getConstrainedAxis(adjEnv, adjBoundaryA1.position);
+        if (order >= 1) frame.axis[1] = getConstrainedAxisDt(adjEnv, adjBoundaryA1.position);
+        // TODO: for now the axis constrained case only works once. If the tool isn't big enough, chaining constrained envelopes together won't work as it needs higher the higher derivatives of the envelope and normal.
+        if (order >= 2) frame.axis[2] = toolMovement.getAxisDt2At(t);
+        if (order >= 3) frame.axis[3] = toolMovement.getAxisDt3At(t);
+        if (order >= 4) frame.axis[4] = toolMovement.getAxisDt4At(t);
+    }
+    else if (isTanContinuous())
     {
-        QVector3D axis = getAxisAt(t); // unit vector
-        QVector3D axis_t = getAxisDtAt(t); // derivative of unit vector
-        QVector3D adjEnv_t = adjEnvA0->getEnvelopeDtAt(t, 1); // not yet unit vector
-        QVector3D adjEnv_tt = adjEnvA0->getEnvelopeDt2At(t, 1); // not yet derivative of unit vector
-        float dotValue = -tool->getSphereRadiusDaAt(0) / tool->getSphereCenterHeightDaAt(0);
-
-        // MATH
-        QVector3D v = adjEnv_t.normalized();
-        QVector3D v_t = MathUtility::normalVectorDerivative(adjEnv_t, adjEnv_tt);
-        QVector3D p = QVector3D(0,1,0);
-        if (p == v) p = QVector3D(1,0,0);
-        QVector3D w1 = p - QVector3D::dotProduct(p, v) * v;
-        QVector3D w1_t = -(QVector3D::dotProduct(p, v) * v_t + QVector3D::dotProduct(p, v_t) * v);
-        w1_t = MathUtility::normalVectorDerivative(w1, w1_t);
-        w1.normalize();
-        QVector3D w2 = QVector3D::crossProduct(v, w1);
-        QVector3D w2_t = QVector3D::crossProduct(v_t, w1) + QVector3D::crossProduct(v, w1_t);
-        float a_dot_w1 = QVector3D::dotProduct(axis, w1);
-        float a_dot_w1_t = QVector3D::dotProduct(axis_t, w1) + QVector3D::dotProduct(axis, w1_t);
-        float a_dot_w2 = QVector3D::dotProduct(axis, w2);
-        float a_dot_w2_t = QVector3D::dotProduct(axis_t, w2) + QVector3D::dotProduct(axis, w2_t);
-
-        float phi = atan2(a_dot_w2, a_dot_w1);
-        float theta = phi - acos(dotValue / sqrt(a_dot_w1 * a_dot_w1 + a_dot_w2 * a_dot_w2));
-        float c_theta = cos(theta);
-        float s_theta = sin(theta);
-        float theta_t = -(c_theta * a_dot_w1_t + s_theta * a_dot_w2_t) /
-                        (-s_theta * a_dot_w1 + c_theta * a_dot_w2);
-
-        QVector3D normal_t = theta_t * (-s_theta * w1 + c_theta * w2) + c_theta * w1_t + s_theta * w2_t;
-
-        return adjEnv_t - tool->getSphereRadiusAt(0) * normal_t - tool->getSphereCenterHeightAt(0) * axis_t;
+        // Rotate the normal of the adjacent envelope around the cross product with the axis of the adjacent envelope
+        QQuaternion rotation = calcAxisRotation(adjNormal[0], adjBoundary.axis[0], t);
+        for (int k = 0; k <= order; k++) {
+            frame.axis[k] = rotation * adjBoundary.axis[k];
+        }
+    }
+    else if (order <= 1)
+    {
+        // For low orders one Taylor propagation is faster than the separate derivative functions
+        toolMovement.getAxisTaylorAt<1>(t).derivatives(frame.axis);
     }
     else
     {
-        return toolMovement.getPath().getDerivativeAt(t);
+        frame.axis[0] = toolMovement.getAxisAt(t);
+        if (order >= 1) frame.axis[1] = toolMovement.getAxisDtAt(t);
+        if (order >= 2) frame.axis[2] = toolMovement.getAxisDt2At(t);
+        if (order >= 3) frame.axis[3] = toolMovement.getAxisDt3At(t);
+        if (order >= 4) frame.axis[4] = toolMovement.getAxisDt4At(t);
     }
-}
 
-QVector3D Envelope::getPathDt2At(float t)
-{
+    // Path
+    const SimplePath &path = toolMovement.getPath();
     if (isTanContinuous())
     {
-        return adjEnvA0->getEnvelopeDt2At(t, 1) - tool->getSphereRadiusAt(0) * adjEnvA0->getNormalDt2At(t, 1) - tool->getSphereCenterHeightAt(0) * getAxisDt2At(t);
+        for (int k = 0; k <= std::min(order, 2); k++) {
+            frame.path[k] = adjEnv[k] - tool->getSphereRadiusAt(0) * adjNormal[k] - tool->getSphereCenterHeightAt(0) * frame.axis[k];
+        }
     }
     else if (isPositContinuous())
     {
-        QVector3D axis = getAxisAt(t); // unit vector
-        QVector3D axis_t = getAxisDtAt(t); // derivative of unit vector
-        QVector3D axis_tt = getAxisDt2At(t); // 2nd derivative of unit vector
-        QVector3D adjEnv_t = adjEnvA0->getEnvelopeDtAt(t, 1); // not yet unit vector
-        QVector3D adjEnv_tt = adjEnvA0->getEnvelopeDt2At(t, 1); // not yet derivative of unit vector
-        QVector3D adjEnv_ttt = adjEnvA0->getEnvelopeDt3At(t, 1); // not yet derivative of unit vector
-        float dotValue = -tool->getSphereRadiusDaAt(0) / tool->getSphereCenterHeightDaAt(0);
-
-        // MATH
-        QVector3D v = adjEnv_t.normalized();
-        QVector3D v_t = MathUtility::normalVectorDerivative(adjEnv_t, adjEnv_tt);
-        QVector3D v_tt = MathUtility::normalVectorDerivative2(adjEnv_t, adjEnv_tt, adjEnv_ttt);
-        QVector3D p = QVector3D(0,1,0);
-        if (p == v) p = QVector3D(1,0,0);
-        QVector3D w1 = p - QVector3D::dotProduct(p, v) * v;
-        QVector3D w1_t = -(QVector3D::dotProduct(p, v_t) * v + QVector3D::dotProduct(p, v) * v_t);
-        QVector3D w1_tt = -(QVector3D::dotProduct(p, v_tt) * v + 2 * QVector3D::dotProduct(p, v_t) * v_t + QVector3D::dotProduct(p, v) * v_tt);
-        w1_tt = MathUtility::normalVectorDerivative2(w1, w1_t, w1_tt);
-        w1_t = MathUtility::normalVectorDerivative(w1, w1_t);
-        w1.normalize();
-        QVector3D w2 = QVector3D::crossProduct(v, w1);
-        QVector3D w2_t = QVector3D::crossProduct(v_t, w1) + QVector3D::crossProduct(v, w1_t);
-        QVector3D w2_tt = QVector3D::crossProduct(v_tt, w1) + 2 * QVector3D::crossProduct(v_t, w1_t) + QVector3D::crossProduct(v, w1_tt);
-        float a_dot_w1 = QVector3D::dotProduct(axis, w1);
-        float a_dot_w1_t = QVector3D::dotProduct(axis_t, w1) + QVector3D::dotProduct(axis, w1_t);
-        float a_dot_w1_tt = QVector3D::dotProduct(axis_tt, w1) + 2 * QVector3D::dotProduct(axis_t, w1_t) + QVector3D::dotProduct(axis, w1_tt);
-        float a_dot_w2 = QVector3D::dotProduct(axis, w2);
-        float a_dot_w2_t = QVector3D::dotProduct(axis_t, w2) + QVector3D::dotProduct(axis, w2_t);
-        float a_dot_w2_tt = QVector3D::dotProduct(axis_tt, w2) + 2 * QVector3D::dotProduct(axis_t, w2_t) + QVector3D::dotProduct(axis, w2_tt);
-
-        float phi = atan2(a_dot_w2, a_dot_w1);
-        float theta = phi - acos(dotValue / sqrt(a_dot_w1 * a_dot_w1 + a_dot_w2 * a_dot_w2));
-        float c_theta = cos(theta);
-        float s_theta = sin(theta);
-
-        float k = c_theta * a_dot_w1_t + s_theta * a_dot_w2_t;
-        float l = -s_theta * a_dot_w1 + c_theta * a_dot_w2;
-        float theta_t = -k / l;
-
-        float dk = theta_t * -s_theta * a_dot_w1_t + c_theta * a_dot_w1_tt +
-                   theta_t * c_theta * a_dot_w2_t + s_theta * a_dot_w2_tt;
-        float dl = -(theta_t * c_theta * a_dot_w1 + s_theta * a_dot_w1_t) +
-                   theta_t * -s_theta * a_dot_w2 + c_theta + a_dot_w2_t;
-        float theta_tt = -(l * dk - k * dl) / (l * l);
-
-
-        QVector3D i = -s_theta * w1 + c_theta * w2;
-        QVector3D di = -(theta_t * c_theta * w1 + s_theta * w1_t) +
-                     theta_t * -s_theta * w2 + c_theta * w2_t;
-        QVector3D normal_t = theta_t * i + c_theta * w1_t + s_theta * w2_t;
-        QVector3D normal_tt = theta_tt * i + theta_t * di +
-                            theta_t * -s_theta * w1_t + c_theta * w1_tt +
-                            theta_t * c_theta * w2_t + s_theta * w2_tt;
-
-        return adjEnv_tt - tool->getSphereRadiusAt(0) * normal_tt - tool->getSphereCenterHeightAt(0) * axis_tt;
+        frame.path[0] = getPositContPath(adjEnv, frame.axis);
+        if (order >= 1) frame.path[1] = getPositContPathDt(adjEnv, frame.axis);
+        if (order >= 2) frame.path[2] = getPositContPathDt2(adjEnv, frame.axis);
+    }
+    else if (order <= 1)
+    {
+        path.getPathTaylorAt<1>(t).derivatives(frame.path);
     }
     else
     {
-        return toolMovement.getPath().getDerivative2At(t);
+        frame.path[0] = path.getPathAt(t);
+        if (order >= 1) frame.path[1] = path.getDerivativeAt(t);
+        if (order >= 2) frame.path[2] = path.getDerivative2At(t);
     }
+    // Need to check if these are required for chaining position continuous envelopes
+    if (order >= 3) frame.path[3] = path.getDerivative3At(t);
+    if (order >= 4) frame.path[4] = path.getDerivative4PlusAt(t);
+
+    return frame;
+}
+
+/**
+ * @brief Envelope::getAdjacentOrder Gives the order up to which a frame of the given order needs the boundary a=1 of the adjacent envelope.
+ * @param order Order of the frame.
+ * @return
+ */
+int Envelope::getAdjacentOrder(int order) const
+{
+    if (isTanContinuous()) return std::max(std::min(order, 2), order - 1);
+    if (isAxisConstrained()) return std::max(std::min(order, 2) + 1, 2);
+    return std::min(order, 2) + 1;
 }
 
-QVector3D Envelope::getPathDt3At(float t)
+/**
+ * @brief Envelope::getBoundaryAt Gets the position, normal and axis of the envelope on the boundary a, with their t-derivatives up to the given order.
+ * Samples at the t of the grid rows are cached until the envelope is invalidated, so dependent envelopes do not recurse through the whole chain for every row.
+ * @param t Time.
+ * @param a Either 0 or 1.
+ * @param order Highest derivative of the position and normal, at most BoundarySample::MAX_ORDER.
+ * @return
+ */
+BoundarySample Envelope::getBoundaryAt(float t, float a, int order) const
+{
+    BoundaryCurve &curve = (a == 0) ? boundaryA0 : boundaryA1;
+    BoundarySample sample;
+    if (curve.find(t, order, sample)) return sample;
+
+    EnvelopeFrame frame = computeFrameAt(t, order + 1);
+    sample.t = t;
+    sample.order = order;
+    for (int k = 0; k <= order + 1; k++) {
+        sample.axis[k] = frame.axis[k];
+    }
+    EnvelopeJet jet = evaluateJet(frame, a, order);
+    for (int k = 0; k <= order; k++) {
+        sample.position[k] = jet.position[k];
+        sample.normal[k] = jet.normal[k];
+    }
+
+    curve.store(sample, sectorsT);
+    return sample;
+}
+
+QVector3D Envelope::getPathAt(float t) const
+{
+    return computeFrameAt(t, 0).path[0];
+}
+
+QVector3D Envelope::getPathDtAt(float t) const
+{
+    return computeFrameAt(t, 1).path[1];
+}
+
+QVector3D Envelope::getPathDt2At(float t) const
+{
+    return computeFrameAt(t, 2).path[2];
+}
+
+QVector3D Envelope::getPathDt3At(float t) const
 {
     // Need to check if these are required for chaining position continuous envelopes
     return toolMovement.getPath().getDerivative3At(t);
 }
 
-QVector3D Envelope::getPathDt4At(float t)
+QVector3D Envelope::getPathDt4At(float t) const
 {
     // Need to check if these are required for chaining position continuous envelopes
     return toolMovement.getPath().getDerivative4PlusAt(t);
 }
 
+/**
+ * @brief Envelope::getPositContPath Calculates the path of a position continuous envelope.
+ * @param adjEnv The boundary of the adjacent envelope and its first derivative.
+ * @param axis The axis of this envelope.
+ * @return
+ */
+QVector3D Envelope::getPositContPath(const QVector3D *adjEnv, const QVector3D *axis) const
+{
+    // The normal is orthogonal to X_t of the adjacent envelope, and at an angle to the axis of its own envelope.
+    // Thus start with the cross product of these two, and rotate it a certain amount around X_t of the adjacent.
+    QVector3D adjEnv_0 = adjEnv[0];
+    QVector3D adjEnv_t = adjEnv[1];
+    QVector3D axis_0 = axis[0];
+    float dotValue = -tool->getSphereRadiusDaAt(0) / tool->getSphereCenterHeightDaAt(0);
+
+    // MATH
+    QVector3D v = adjEnv_t.normalized();
+    QVector3D p = QVector3D(0,1,0);
+    if (p == v) p = QVector3D(1,0,0);
+    QVector3D w1 = (p - QVector3D::dotProduct(p, v) * v).normalized();
+    QVector3D w2 = QVector3D::crossProduct(v, w1);
+    float a_dot_w1 = QVector3D::dotProduct(axis_0, w1);
+    float a_dot_w2 = QVector3D::dotProduct(axis_0, w2);
+
+    float phi = atan2(a_dot_w2, a_dot_w1);
+    float theta = phi - acos(dotValue / sqrt(a_dot_w1 * a_dot_w1 + a_dot_w2 * a_dot_w2));
+
+    QVector3D normal = w1 * cos(theta) + w2 * sin(theta);
+
+    return adjEnv_0 - tool->getSphereRadiusAt(0) * normal - tool->getSphereCenterHeightAt(0) * axis_0;
+}
 
-QQuaternion Envelope::calcAxisRotationAt(float t)
+/**
+ * @brief Envelope::getPositContPathDt Calculates the first derivative of the path of a position continuous envelope.
+ * @param adjEnv The boundary of the adjacent envelope and its first two derivatives.
+ * @param axis The axis of this envelope and its first derivative.
+ * @return
+ */
+QVector3D Envelope::getPositContPathDt(const QVector3D *adjEnv, const QVector3D *axis) const
+{
+    QVector3D axis_0 = axis[0]; // unit vector
+    QVector3D axis_t = axis[1]; // derivative of unit vector
+    QVector3D adjEnv_t = adjEnv[1]; // not yet unit vector
+    QVector3D adjEnv_tt = adjEnv[2]; // not yet derivative of unit vector
+    float dotValue = -tool->getSphereRadiusDaAt(0) / tool->getSphereCenterHeightDaAt(0);
+
+    // MATH
+    QVector3D v = adjEnv_t.normalized();
+    QVector3D v_t = MathUtility::normalVectorDerivative(adjEnv_t, adjEnv_tt);
+    QVector3D p = QVector3D(0,1,0);
+    if (p == v) p = QVector3D(1,0,0);
+    QVector3D w1 = p - QVector3D::dotProduct(p, v) * v;
+    QVector3D w1_t = -(QVector3D::dotProduct(p, v) * v_t + QVector3D::dotProduct(p, v_t) * v);
+    w1_t = MathUtility::normalVectorDerivative(w1, w1_t);
+    w1.normalize();
+    QVector3D w2 = QVector3D::crossProduct(v, w1);
+    QVector3D w2_t = QVector3D::crossProduct(v_t, w1) + QVector3D::crossProduct(v, w1_t);
+    float a_dot_w1 = QVector3D::dotProduct(axis_0, w1);
+    float a_dot_w1_t = QVector3D::dotProduct(axis_t, w1) + QVector3D::dotProduct(axis_0, w1_t);
+    float a_dot_w2 = QVector3D::dotProduct(axis_0, w2);
+    float a_dot_w2_t = QVector3D::dotProduct(axis_t, w2) + QVector3D::dotProduct(axis_0, w2_t);
+
+    float phi = atan2(a_dot_w2, a_dot_w1);
+    float theta = phi - acos(dotValue / sqrt(a_dot_w1 * a_dot_w1 + a_dot_w2 * a_dot_w2));
+    float c_theta = cos(theta);
+    float s_theta = sin(theta);
+    float theta_t = -(c_theta * a_dot_w1_t + s_theta * a_dot_w2_t) /
+                    (-s_theta * a_dot_w1 + c_theta * a_dot_w2);
+
+    QVector3D normal_t = theta_t * (-s_theta * w1 + c_theta * w2) + c_theta * w1_t + s_theta * w2_t;
+
+    return adjEnv_t - tool->getSphereRadiusAt(0) * normal_t - tool->getSphereCenterHeightAt(0) * axis_t;
+}
+
+/**
+ * @brief Envelope::getPositContPathDt2 Calculates the second derivative of the path of a position continuous envelope.
+ * @param adjEnv The boundary of the adjacent envelope and its first three derivatives.
+ * @param axis The axis of this envelope and its first two derivatives.
+ * @return
+ */
+QVector3D Envelope::getPositContPathDt2(const QVector3D *adjEnv, const QVector3D *axis) const
+{
+    QVector3D axis_0 = axis[0]; // unit vector
+    QVector3D axis_t = axis[1]; // derivative of unit vector
+    QVector3D axis_tt = axis[2]; // 2nd derivative of unit vector
+    QVector3D adjEnv_t = adjEnv[1]; // not yet unit vector
+    QVector3D adjEnv_tt = adjEnv[2]; // not yet derivative of unit vector
+    QVector3D adjEnv_ttt = adjEnv[3]; // not yet derivative of unit vector
+    float dotValue = -tool->getSphereRadiusDaAt(0) / tool->getSphereCenterHeightDaAt(0);
+
+    // MATH
+    QVector3D v = adjEnv_t.normalized();
+    QVector3D v_t = MathUtility::normalVectorDerivative(adjEnv_t, adjEnv_tt);
+    QVector3D v_tt = MathUtility::normalVectorDerivative2(adjEnv_t, adjEnv_tt, adjEnv_ttt);
+    QVector3D p = QVector3D(0,1,0);
+    if (p == v) p = QVector3D(1,0,0);
+    QVector3D w1 = p - QVector3D::dotProduct(p, v) * v;
+    QVector3D w1_t = -(QVector3D::dotProduct(p, v_t) * v + QVector3D::dotProduct(p, v) * v_t);
+    QVector3D w1_tt = -(QVector3D::dotProduct(p, v_tt) * v + 2 * QVector3D::dotProduct(p, v_t) * v_t + QVector3D::dotProduct(p, v) * v_tt);
+    w1_tt = MathUtility::normalVectorDerivative2(w1, w1_t, w1_tt);
+    w1_t = MathUtility::normalVectorDerivative(w1, w1_t);
+    w1.normalize();
+    QVector3D w2 = QVector3D::crossProduct(v, w1);
+    QVector3D w2_t = QVector3D::crossProduct(v_t, w1) + QVector3D::crossProduct(v, w1_t);
+    QVector3D w2_tt = QVector3D::crossProduct(v_tt, w1) + 2 * QVector3D::crossProduct(v_t, w1_t) + QVector3D::crossProduct(v, w1_tt);
+    float a_dot_w1 = QVector3D::dotProduct(axis_0, w1);
+    float a_dot_w1_t = QVector3D::dotProduct(axis_t, w1) + QVector3D::dotProduct(axis_0, w1_t);
+    float a_dot_w1_tt = QVector3D::dotProduct(axis_tt, w1) + 2 * QVector3D::dotProduct(axis_t, w1_t) + QVector3D::dotProduct(axis_0, w1_tt);
+    float a_dot_w2 = QVector3D::dotProduct(axis_0, w2);
+    float a_dot_w2_t = QVector3D::dotProduct(axis_t, w2) + QVector3D::dotProduct(axis_0, w2_t);
+    float a_dot_w2_tt = QVector3D::dotProduct(axis_tt, w2) + 2 * QVector3D::dotProduct(axis_t, w2_t) + QVector3D::dotProduct(axis_0, w2_tt);
+
+    float phi = atan2(a_dot_w2, a_dot_w1);
+    float theta = phi - acos(dotValue / sqrt(a_dot_w1 * a_dot_w1 + a_dot_w2 * a_dot_w2));
+    float c_theta = cos(theta);
+    float s_theta = sin(theta);
+
+    float k = c_theta * a_dot_w1_t + s_theta * a_dot_w2_t;
+    float l = -s_theta * a_dot_w1 + c_theta * a_dot_w2;
+    float theta_t = -k / l;
+
+    float dk = theta_t * -s_theta * a_dot_w1_t + c_theta * a_dot_w1_tt +
+               theta_t * c_theta * a_dot_w2_t + s_theta * a_dot_w2_tt;
+    float dl = -(theta_t * c_theta * a_dot_w1 + s_theta * a_dot_w1_t) +
+               theta_t * -s_theta * a_dot_w2 + c_theta + a_dot_w2_t;
+    float theta_tt = -(l * dk - k * dl) / (l * l);
+
+
+    QVector3D i = -s_theta * w1 + c_theta * w2;
+    QVector3D di = -(theta_t * c_theta * w1 + s_theta * w1_t) +
+                 theta_t * -s_theta * w2 + c_theta * w2_t;
+    QVector3D normal_t = theta_t * i + c_theta * w1_t + s_theta * w2_t;
+    QVector3D normal_tt = theta_tt * i + theta_t * di +
+                        theta_t * -s_theta * w1_t + c_theta * w1_tt +
+                        theta_t * c_theta * w2_t + s_theta * w2_tt;
+
+    return adjEnv_tt - tool->getSphereRadiusAt(0) * normal_tt - tool->getSphereCenterHeightAt(0) * axis_tt;
+}
+
+
+QQuaternion Envelope::calcAxisRotationAt(float t) const
 {
     if (!isTanContinuous()) return QQuaternion();
+    BoundarySample adjBoundary = adjEnvA0->getBoundaryAt(t, 1, 0);
+    return calcAxisRotation(adjBoundary.normal[0], adjBoundary.axis[0], t);
+}
+
+/**
+ * @brief Envelope::calcAxisRotation Calculates the rotation from the axis of the adjacent envelope to the axis of this tangent continuous envelope.
+ * @param adjNormal The normal of the adjacent envelope at a=1.
+ * @param adjAxis The axis of the adjacent envelope.
+ * @param t Time.
+ * @return
+ */
+QQuaternion Envelope::calcAxisRotation(const QVector3D &adjNormal, const QVector3D &adjAxis, float t) const
+{
     // First rotate the axis of the previous envelope to its normal.
     // This is to establish a frame of reference for all its derivatives.
-    QVector3D adjNormal = adjEnvA0->getNormalAt(t, 1);
-    QVector3D adjAxis = adjEnvA0->getAxisAt(t);
     QQuaternion rotationFrame = QQuaternion::rotationTo(adjAxis, adjNormal);
 
     // Then rotate w.r.t. tangent continuity. Which rotates around the cross product of the adjacent normal and axis
@@ -764,210 +1132,173 @@ QQuaternion Envelope::calcAxisRotationAt(float t)
     return rotationFree * rotationTangent * rotationFrame;
 }
 
-QVector3D Envelope::getAxisAt(float t)
+QVector3D Envelope::getAxisAt(float t) const
 {
-    QVector3D axis;
-    if (isAxisConstrained())
-    {
-        QVector3D x0 = adjEnvA0->getEnvelopeAt(t, 1);
-        QVector3D x1 = adjEnvA1->getEnvelopeAt(t, 0);
-        QVector3D deltaX = x1 - x0;
-        QVector3D deltaX_hat = deltaX.normalized();
-
-        QVector3D x0_t = adjEnvA0->getEnvelopeDtAt(t, 1);
-        QVector3D x1_t = adjEnvA1->getEnvelopeDtAt(t, 0);
-        QVector3D x0_t_hat = x0_t.normalized();
-        QVector3D x1_t_hat = x1_t.normalized();
-
-        // The following method only works when Delta X can be made with a cylinder of hight and radius of 1, where x1 lies on the bottom ring of the cylinder and x2 on the top ring.
-
-        // Separately find the parts of the axis parallel and perpendicular to Delta X
-        // By utilizing Delta X dot A = 1 we can calculate the angle between Delta X and A
-        float c_theta = std::clamp(1.0f / deltaX.length(), -1.0f, 1.0f);
-        float s_theta = sqrt(1 - c_theta * c_theta);
-        QVector3D axis_par_deltaX = c_theta * deltaX_hat;
-
-        // For the perpendicular part we make an orthonormal basis on the plane perpendicular to Delta X, with radius Sin(theta)
-        QVector3D v = QVector3D(0,1,0);
-        if (v == deltaX_hat) v = QVector3D(1,0,0);
-        QVector3D v1 = v - QVector3D::dotProduct(v, deltaX_hat) * deltaX_hat;
-        v1 = s_theta * v1.normalized();
-        QVector3D v2 = QVector3D::crossProduct(deltaX_hat, v1);
-
-        // The normals at x1 and x2 are perpendicular to the respective time derivates, as well as the axis.
-        // This means each normal is the cross product of the time derivative and the axis (which is split in the parallel and perpendicular part).
-        // This eventually leads to the form A*cos(phi) + B*sin(phi)=C, where A, B, and C are all coplanar vectors (by construction), which is the only reason this works.
-        QVector3D D = v1 - QVector3D::crossProduct(x1_t_hat, v1) + QVector3D::crossProduct(x0_t_hat, v1);
-        QVector3D E = v2 - QVector3D::crossProduct(x1_t_hat, v2) + QVector3D::crossProduct(x0_t_hat, v2);
-        QVector3D F = deltaX + QVector3D::crossProduct(x1_t_hat, axis_par_deltaX) - QVector3D::crossProduct(x0_t_hat, axis_par_deltaX) - axis_par_deltaX;
-
-        // By using dot product we can find phi
-        float h = QVector3D::dotProduct(D, D);
-        float i = QVector3D::dotProduct(D, E);
-        float j = QVector3D::dotProduct(E, E);
-        float k = QVector3D::dotProduct(D, F);
-        float l = QVector3D::dotProduct(E, F);
-        float phi = atan2(l * h - k * i, k * j - l * i);
-        float c_phi = cos(phi);
-        float s_phi = sin(phi);
-
-        QVector3D axis_perp_deltaX = v1 * c_phi + v2 * s_phi;
-        axis = axis_par_deltaX + axis_perp_deltaX;
-    }
-    else if (isTanContinuous())
-    {
-        // Rotate the normal of the adjacent envelope around the cross product with the axis of the adjacent envelope
-        axis = calcAxisRotationAt(t) * adjEnvA0->getAxisAt(t);
-    }
-    else
-    {
-        axis = toolMovement.getAxisAt(t);
-    }
-    return axis;
+    return computeFrameAt(t, 0).axis[0];
 }
 
-QVector3D Envelope::getAxisDtAt(float t)
+QVector3D Envelope::getAxisDtAt(float t) const
 {
-    QVector3D axis, axis_t;
-    if (isAxisConstrained())
-    {
-        QVector3D x0 = adjEnvA0->getEnvelopeAt(t, 1);
-        QVector3D x1 = adjEnvA1->getEnvelopeAt(t, 0);
-        QVector3D deltaX = x1 - x0;
-        QVector3D deltaX_hat = deltaX.normalized();
-
-        QVector3D x0_t = adjEnvA0->getEnvelopeDtAt(t, 1);
-        QVector3D x1_t = adjEnvA1->getEnvelopeDtAt(t, 0);
-        QVector3D deltaX_t = x1_t - x0_t;
-        QVector3D deltaX_hat_t = MathUtility::normalVectorDerivative(deltaX, deltaX_t);
-        QVector3D x0_t_hat = x0_t.normalized();
-        QVector3D x1_t_hat = x1_t.normalized();
-
-        QVector3D x0_tt = adjEnvA0->getEnvelopeDt2At(t, 1);
-        QVector3D x1_tt = adjEnvA1->getEnvelopeDt2At(t, 0);
-        QVector3D x0_t_hat_t = MathUtility::normalVectorDerivative(x0_t, x0_tt);
-        QVector3D x1_t_hat_t = MathUtility::normalVectorDerivative(x1_t, x1_tt);
-
-        // The following method only works when Delta X can be made with a cylinder of hight and radius of 1, where x1 lies on the bottom ring of the cylinder and x2 on the top ring.
-
-        // Separately find the parts of the axis parallel and perpendicular to Delta X
-        // By utilizing Delta X dot A = 1 we can calculate the angle between Delta X and A
-        float c_theta = std::clamp(1.0f / deltaX.length(), -1.0f, 1.0f);
-        float c_theta_t = -QVector3D::dotProduct(deltaX, deltaX_t) / pow(deltaX.length(), 3);
-        float s_theta = sqrt(1 - c_theta * c_theta);
-        float s_theta_t = -c_theta * c_theta_t / s_theta;
-        if (s_theta == 0)
-        {
-            s_theta_t = 0;
-        }
-        QVector3D axis_par_deltaX = c_theta * deltaX_hat;
-        QVector3D axis_par_deltaX_t = c_theta_t * deltaX_hat + c_theta * deltaX_hat_t;
-
-        // For the perpendicular part we make an orthonormal basis on the plane perpendicular to Delta X, with radius Sin(theta)
-        QVector3D v = QVector3D(0,1,0);
-        if (v == deltaX_hat) v = QVector3D(1,0,0);
-        QVector3D v1 = v - QVector3D::dotProduct(v, deltaX_hat) * deltaX_hat;
-        QVector3D v1_t = -(QVector3D::dotProduct(v, deltaX_hat_t) * deltaX_hat + QVector3D::dotProduct(v, deltaX_hat) * deltaX_hat_t);
-        v1_t = s_theta_t * v1.normalized() + s_theta * MathUtility::normalVectorDerivative(v1, v1_t);
-        v1 = s_theta * v1.normalized();
-        QVector3D v2 = QVector3D::crossProduct(deltaX_hat, v1);
-        QVector3D v2_t = QVector3D::crossProduct(deltaX_hat_t, v1) + QVector3D::crossProduct(deltaX_hat, v1_t);
-
-        // The normals at x1 and x2 are perpendicular to the respective time derivates, as well as the axis.
-        // This means each normal is the cross product of the time derivative and the axis (which is split in the parallel and perpendicular part).
-        // This eventually leads to the form A*cos(phi) + B*sin(phi)=C, where A, B, and C are all coplanar vectors (by construction), which is the only reason this works.
-        QVector3D D = v1 - QVector3D::crossProduct(x1_t_hat, v1) + QVector3D::crossProduct(x0_t_hat, v1);
-        QVector3D D_t = v1_t -
-                      (QVector3D::crossProduct(x1_t_hat_t, v1) + QVector3D::crossProduct(x1_t_hat, v1_t)) +
-                      (QVector3D::crossProduct(x0_t_hat_t, v1) + QVector3D::crossProduct(x0_t_hat, v1_t));
-        QVector3D E = v2 - QVector3D::crossProduct(x1_t_hat, v2) + QVector3D::crossProduct(x0_t_hat, v2);
-        QVector3D E_t = v2_t -
-                      (QVector3D::crossProduct(x1_t_hat_t, v2) + QVector3D::crossProduct(x1_t_hat, v2_t)) +
-                      (QVector3D::crossProduct(x0_t_hat_t, v2) + QVector3D::crossProduct(x0_t_hat, v2_t));
-        QVector3D F = deltaX + QVector3D::crossProduct(x1_t_hat, axis_par_deltaX) - QVector3D::crossProduct(x0_t_hat, axis_par_deltaX) - axis_par_deltaX;
-        QVector3D F_t = deltaX_t +
-                      (QVector3D::crossProduct(x1_t_hat_t, axis_par_deltaX) + QVector3D::crossProduct(x1_t_hat, axis_par_deltaX_t)) -
-                      (QVector3D::crossProduct(x0_t_hat_t, axis_par_deltaX) + QVector3D::crossProduct(x0_t_hat, axis_par_deltaX_t)) -
-                      axis_par_deltaX_t;
-
-        // By using dot product we can find phi
-        float h = QVector3D::dotProduct(D, D);
-        float i = QVector3D::dotProduct(D, E);
-        float j = QVector3D::dotProduct(E, E);
-        float k = QVector3D::dotProduct(D, F);
-        float l = QVector3D::dotProduct(E, F);
-        float phi = atan2(l * h - k * i, k * j - l * i);
-        float c_phi = cos(phi);
-        float s_phi = sin(phi);
-
-        QVector3D helper = -D * s_phi + E * c_phi;
-        float phi_t = QVector3D::dotProduct(helper, F_t - D_t * c_phi - E_t * s_phi) / helper.lengthSquared();
-        if (helper.lengthSquared() == 0)
-        {
-            phi_t = 0;
-        }
+    return computeFrameAt(t, 1).axis[1];
+}
 
-        QVector3D axis_perp_deltaX = v1 * c_phi + v2 * s_phi;
-        QVector3D axis_perp_deltaX_t = v1_t * c_phi + v1 * phi_t * -s_phi +
-                                     v2_t * s_phi + v2 * phi_t * c_phi;
-        axis = axis_par_deltaX + axis_perp_deltaX;
+QVector3D Envelope::getAxisDt2At(float t) const
+{
+    return computeFrameAt(t, 2).axis[2];
+}
 
-        axis_t = axis_par_deltaX_t + axis_perp_deltaX_t;
-    }
-    else if (isTanContinuous())
-    {
-        axis_t = calcAxisRotationAt(t) * adjEnvA0->getAxisDtAt(t);
-    }
-    else
-    {
-        axis_t = toolMovement.getAxisDtAt(t);
-    }
-    return axis_t;
+QVector3D Envelope::getAxisDt3At(float t) const
+{
+    return computeFrameAt(t, 3).axis[3];
 }
 
-QVector3D Envelope::getAxisDt2At(float t)
+QVector3D Envelope::getAxisDt4At(float t) const
 {
-    // TODO: for now the axis constrained case only works once. If the tool isn't big enough, chaining constrained envelopes together won't work as it needs higher the higher derivatives of the envelope and normal.
-    QVector3D axis, axis_t, axis_tt;
-    if (isTanContinuous())
-    {
-        axis_tt = calcAxisRotationAt(t) * adjEnvA0->getAxisDt2At(t);
-    }
-    else
-    {
-        axis_tt = toolMovement.getAxisDt2At(t);
-    }
-    return axis_tt;
+    return computeFrameAt(t, 4).axis[4];
 }
 
-QVector3D Envelope::getAxisDt3At(float t)
+/**
+ * @brief Envelope::getConstrainedAxis Calculates the axis of an envelope constrained between two adjacent envelopes.
+ * @param x0 The boundary a=1 of the envelope adjacent at a=0, and its first derivative.
+ * @param x1 The boundary a=0 of the envelope adjacent at a=1, and its first derivative.
+ * @return
+ */
+QVector3D Envelope::getConstrainedAxis(const QVector3D *x0, const QVector3D *x1) const
 {
-    // TODO: for now the axis constrained case only works once. If the tool isn't big enough, chaining constrained envelopes together won't work as it needs higher the higher derivatives of the envelope and normal.
-    QVector3D axis, axis_t, axis_tt, axis_ttt;
-    if (isTanContinuous())
-    {
-        axis_ttt = calcAxisRotationAt(t) * adjEnvA0->getAxisDt3At(t);
-    }
-    else
-    {
-        axis_ttt = toolMovement.getAxisDt3At(t);
-    }
-    return axis_ttt;
+    QVector3D x0_0 = x0[0];
+    QVector3D x1_0 = x1[0];
+    QVector3D deltaX = x1_0 - x0_0;
+    QVector3D deltaX_hat = deltaX.normalized();
+
+    QVector3D x0_t = x0[1];
+    QVector3D x1_t = x1[1];
+    QVector3D x0_t_hat = x0_t.normalized();
+    QVector3D x1_t_hat = x1_t.normalized();
+
+    // The following method only works when Delta X can be made with a cylinder of hight and radius of 1, where x1 lies on the bottom ring of the cylinder and x2 on the top ring.
+
+    // Separately find the parts of the axis parallel and perpendicular to Delta X
+    // By utilizing Delta X dot A = 1 we can calculate the angle between Delta X and A
+    float c_theta = std::clamp(1.0f / deltaX.length(), -1.0f, 1.0f);
+    float s_theta = sqrt(1 - c_theta * c_theta);
+    QVector3D axis_par_deltaX = c_theta * deltaX_hat;
+
+    // For the perpendicular part we make an orthonormal basis on the plane perpendicular to Delta X, with radius Sin(theta)
+    QVector3D v = QVector3D(0,1,0);
+    if (v == deltaX_hat) v = QVector3D(1,0,0);
+    QVector3D v1 = v - QVector3D::dotProduct(v, deltaX_hat) * deltaX_hat;
+    v1 = s_theta * v1.normalized();
+    QVector3D v2 = QVector3D::crossProduct(deltaX_hat, v1);
+
+    // The normals at x1 and x2 are perpendicular to the respective time derivates, as well as the axis.
+    // This means each normal is the cross product of the time derivative and the axis (which is split in the parallel and perpendicular part).
+    // This eventually leads to the form A*cos(phi) + B*sin(phi)=C, where A, B, and C are all coplanar vectors (by construction), which is the only reason this works.
+    QVector3D D = v1 - QVector3D::crossProduct(x1_t_hat, v1) + QVector3D::crossProduct(x0_t_hat, v1);
+    QVector3D E = v2 - QVector3D::crossProduct(x1_t_hat, v2) + QVector3D::crossProduct(x0_t_hat, v2);
+    QVector3D F = deltaX + QVector3D::crossProduct(x1_t_hat, axis_par_deltaX) - QVector3D::crossProduct(x0_t_hat, axis_par_deltaX) - axis_par_deltaX;
+
+    // By using dot product we can find phi
+    float h = QVector3D::dotProduct(D, D);
+    float i = QVector3D::dotProduct(D, E);
+    float j = QVector3D::dotProduct(E, E);
+    float k = QVector3D::dotProduct(D, F);
+    float l = QVector3D::dotProduct(E, F);
+    float phi = atan2(l * h - k * i, k * j - l * i);
+    float c_phi = cos(phi);
+    float s_phi = sin(phi);
+
+    QVector3D axis_perp_deltaX = v1 * c_phi + v2 * s_phi;
+    return axis_par_deltaX + axis_perp_deltaX;
 }
 
-QVector3D Envelope::getAxisDt4At(float t)
+/**
+ * @brief Envelope::getConstrainedAxisDt Calculates the first derivative of the axis of an envelope constrained between two adjacent envelopes.
+ * @param x0 The boundary a=1 of the envelope adjacent at a=0, and its first two derivatives.
+ * @param x1 The boundary a=0 of the envelope adjacent at a=1, and its first two derivatives.
+ * @return
+ */
+QVector3D Envelope::getConstrainedAxisDt(const QVector3D *x0, const QVector3D *x1) const
 {
-    // TODO: for now the axis constrained case only works once. If the tool isn't big enough, chaining constrained envelopes together won't work as it needs higher the higher derivatives of the envelope and normal.
-    QVector3D axis, axis_t, axis_tt, axis_ttt, axis_tttt;
-    if (isTanContinuous())
+    QVector3D x0_0 = x0[0];
+    QVector3D x1_0 = x1[0];
+    QVector3D deltaX = x1_0 - x0_0;
+    QVector3D deltaX_hat = deltaX.normalized();
+
+    QVector3D x0_t = x0[1];
+    QVector3D x1_t = x1[1];
+    QVector3D deltaX_t = x1_t - x0_t;
+    QVector3D deltaX_hat_t = MathUtility::normalVectorDerivative(deltaX, deltaX_t);
+    QVector3D x0_t_hat = x0_t.normalized();
+    QVector3D x1_t_hat = x1_t.normalized();
+
+    QVector3D x0_tt = x0[2];
+    QVector3D x1_tt = x1[2];
+    QVector3D x0_t_hat_t = MathUtility::normalVectorDerivative(x0_t, x0_tt);
+    QVector3D x1_t_hat_t = MathUtility::normalVectorDerivative(x1_t, x1_tt);
+
+    // The following method only works when Delta X can be made with a cylinder of hight and radius of 1, where x1 lies on the bottom ring of the cylinder and x2 on the top ring.
+
+    // Separately find the parts of the axis parallel and perpendicular to Delta X
+    // By utilizing Delta X dot A = 1 we can calculate the angle between Delta X and A
+    float c_theta = std::clamp(1.0f / deltaX.length(), -1.0f, 1.0f);
+    float c_theta_t = -QVector3D::dotProduct(deltaX, deltaX_t) / pow(deltaX.length(), 3);
+    float s_theta = sqrt(1 - c_theta * c_theta);
+    float s_theta_t = -c_theta * c_theta_t / s_theta;
+    if (s_theta == 0)
     {
-        axis_tttt = calcAxisRotationAt(t) * adjEnvA0->getAxisDt4At(t);
+        s_theta_t = 0;
     }
-    else
+    QVector3D axis_par_deltaX = c_theta * deltaX_hat;
+    QVector3D axis_par_deltaX_t = c_theta_t * deltaX_hat + c_theta * deltaX_hat_t;
+
+    // For the perpendicular part we make an orthonormal basis on the plane perpendicular to Delta X, with radius Sin(theta)
+    QVector3D v = QVector3D(0,1,0);
+    if (v == deltaX_hat) v = QVector3D(1,0,0);
+    QVector3D v1 = v - QVector3D::dotProduct(v, deltaX_hat) * deltaX_hat;
+    QVector3D v1_t = -(QVector3D::dotProduct(v, deltaX_hat_t) * deltaX_hat + QVector3D::dotProduct(v, deltaX_hat) * deltaX_hat_t);
+    v1_t = s_theta_t * v1.normalized() + s_theta * MathUtility::normalVectorDerivative(v1, v1_t);
+    v1 = s_theta * v1.normalized();
+    QVector3D v2 = QVector3D::crossProduct(deltaX_hat, v1);
+    QVector3D v2_t = QVector3D::crossProduct(deltaX_hat_t, v1) + QVector3D::crossProduct(deltaX_hat, v1_t);
+
+    // The normals at x1 and x2 are perpendicular to the respective time derivates, as well as the axis.
+    // This means each normal is the cross product of the time derivative and the axis (which is split in the parallel and perpendicular part).
+    // This eventually leads to the form A*cos(phi) + B*sin(phi)=C, where A, B, and C are all coplanar vectors (by construction), which is the only reason this works.
+    QVector3D D = v1 - QVector3D::crossProduct(x1_t_hat, v1) + QVector3D::crossProduct(x0_t_hat, v1);
+    QVector3D D_t = v1_t -
+                  (QVector3D::crossProduct(x1_t_hat_t, v1) + QVector3D::crossProduct(x1_t_hat, v1_t)) +
+                  (QVector3D::crossProduct(x0_t_hat_t, v1) + QVector3D::crossProduct(x0_t_hat, v1_t));
+    QVector3D E = v2 - QVector3D::crossProduct(x1_t_hat, v2) + QVector3D::crossProduct(x0_t_hat, v2);
+    QVector3D E_t = v2_t -
+                  (QVector3D::crossProduct(x1_t_hat_t, v2) + QVector3D::crossProduct(x1_t_hat, v2_t)) +
+                  (QVector3D::crossProduct(x0_t_hat_t, v2) + QVector3D::crossProduct(x0_t_hat, v2_t));
+    QVector3D F = deltaX + QVector3D::crossProduct(x1_t_hat, axis_par_deltaX) - QVector3D::crossProduct(x0_t_hat, axis_par_deltaX) - axis_par_deltaX;
+    QVector3D F_t = deltaX_t +
+                  (QVector3D::crossProduct(x1_t_hat_t, axis_par_deltaX) + QVector3D::crossProduct(x1_t_hat, axis_par_deltaX_t)) -
+                  (QVector3D::crossProduct(x0_t_hat_t, axis_par_deltaX) + QVector3D::crossProduct(x0_t_hat, axis_par_deltaX_t)) -
+                  axis_par_deltaX_t;
+
+    // By using dot product we can find phi
+    float h = QVector3D::dotProduct(D, D);
+    float i = QVector3D::dotProduct(D, E);
+    float j = QVector3D::dotProduct(E, E);
+    float k = QVector3D::dotProduct(D, F);
+    float l = QVector3D::dotProduct(E, F);
+    float phi = atan2(l * h - k * i, k * j - l * i);
+    float c_phi = cos(phi);
+    float s_phi = sin(phi);
+
+    QVector3D helper = -D * s_phi + E * c_phi;
+    float phi_t = QVector3D::dotProduct(helper, F_t - D_t * c_phi - E_t * s_phi) / helper.lengthSquared();
+    if (helper.lengthSquared() == 0)
     {
-        axis_tttt = toolMovement.getAxisDt4At(t);
+        phi_t = 0;
     }
-    return axis_tttt;
+
+    QVector3D axis_perp_deltaX = v1 * c_phi + v2 * s_phi;
+    QVector3D axis_perp_deltaX_t = v1_t * c_phi + v1 * phi_t * -s_phi +
+                                 v2_t * s_phi + v2 * phi_t * c_phi;
+        return axis_par_deltaX_t + axis_perp_deltaX_t;
 }
 
 
@@ -975,7 +1306,7 @@ QVector3D Envelope::getAxisDt4At(float t)
  * @brief Envelope::getToolTransform Calculates the transformation matrix of the Envelope's tool relative to the envelope itself. The modelTransform is separate from the toolTransform.
  * @return
  */
-QMatrix4x4 Envelope::getToolTransformAt(float t) {
+QMatrix4x4 Envelope::getToolTransformAt(float t) const {
     // First rotate such that the tool's axis aligns with the surface axis
     QVector3D toolAxis = tool->getAxisVector();
     QMatrix4x4 rotation;
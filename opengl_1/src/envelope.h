@@ -2,10 +2,16 @@
 #define ENVELOPE_H
 
 #include "vertex.h"
+#include "envelopevertex.h"
+#include "envelopeframe.h"
+#include "envelopejet.h"
+#include "boundarycurve.h"
 #include "movement/cylindermovement.h"
 #include <QMatrix2x2>
+#include <QVector2D>
 #include <QQuaternion>
-#include "settings.h"
+#include <QSet>
+#include <functional>
 
 class Envelope
 {
@@ -24,15 +30,41 @@ class Envelope
     int sectorsA;
     int sectorsT;
 
-    QVector<Vertex> vertexArr;
+    // Whether the t rows of the meshes are generated concurrently
+    bool parallel = false;
+
+    // Largest distance between the envelope and its mesh, and largest angle between the normals of a cell in degrees.
+    // The mesh is the uniform sectorsT x sectorsA grid if the distance is 0, and refined adaptively otherwise
+    float tolerance = 0;
+    float angleTolerance = 0;
+
+    // Sectors of the grid below, which may lag behind sectorsA and sectorsT until the next mesh is adopted
+    int gridSectorsA = 0;
+    int gridSectorsT = 0;
+    // Position and normal of every (t,a) node, (gridSectorsT+1) x (gridSectorsA+1) row-major in t.
+    // Empty next to an adaptive mesh until sampleGrid is called
+    QVector<QVector3D> gridPositions;
+    QVector<QVector3D> gridNormals;
+    // Path and axis of every t row
+    QVector<QVector3D> rowPaths;
+    QVector<QVector3D> rowAxes;
+
+    // Cached boundaries a=0 and a=1, read by dependent envelopes
+    mutable BoundaryCurve boundaryA0;
+    mutable BoundaryCurve boundaryA1;
+
+    QVector<EnvelopeVertex> vertexArr;
+    QVector<unsigned int> indexArr;
+    // (t,a) of every vertex of an adaptive mesh. Empty for the uniform mesh, whose vertices are the grid nodes
+    QVector<QVector2D> vertexParams;
+
+    // Debug overlays, computed from the rows on first use after the geometry changed
     QVector<Vertex> vertexArrCenters;
     QVector<Vertex> vertexArrGrazingCurve;
-    QVector<QVector<Vertex>> vertexArrNormals;
-
-    // Render settings for reflection lines
-    bool reflectionLines=false;
-    float reflFreq=20;
-    float percentBlack=0.5;
+    QVector<Vertex> vertexArrNormals;
+    bool centersValid = false;
+    bool grazingCurveValid = false;
+    int normalsTIdx = -1;
 
 
 public:
@@ -40,14 +72,14 @@ public:
     Envelope(int index, Tool *tool, const SimplePath &path);
     Envelope(int index, Tool *tool, const SimplePath &path, Envelope *adjEnvelope);
 
-    inline void updateRenderSettings(const Settings &settings) {
-        reflectionLines=settings.reflectionLines;
-        reflFreq=settings.reflFreq;
-        percentBlack=settings.percentBlack;
-    }
-
     inline void setSectorsA(int n) { sectorsA = n; }
     inline void setSectorsT(int n) { sectorsT = n; }
+    inline int getSectorsA() const { return sectorsA; }
+    inline int getSectorsT() const { return sectorsT; }
+    inline void setParallel(bool value) { parallel = value; }
+    inline void setTolerance(float distance, float angle = 0) { tolerance = distance; angleTolerance = angle; }
+    inline float getTolerance() const { return tolerance; }
+    inline float getAngleTolerance() const { return angleTolerance; }
 
     inline int getIndex() const { return index; }
     inline Envelope *getAdjA0Envelope() { return adjEnvA0; }
@@ -59,49 +91,69 @@ public:
     void deregisterDependent(Envelope *dependent);
     bool checkDependencies();
     QSet<int> getAllDependents();
+    void invalidateBoundaries();
 
     void initEnvelope();
     void update();
 
-    void computeEnvelope();
-    QVector3D getEnvelopeAt(float t, float a);
-    QVector3D getEnvelopeDtAt(float t, float a);
-    QVector3D getEnvelopeDt2At(float t, float a);
-    QVector3D getEnvelopeDt3At(float t, float a);
-
-    void computeToolCenters();
-
-    void computeGrazingCurves();
-
-    void computeNormals();
-    QVector3D getNormalAt(float t, float a);
-    QVector3D getNormalDtAt(float t, float a);
-    QVector3D getNormalDt2At(float t, float a);
-    QVector3D getNormalDt3At(float t, float a);
-
-    QVector3D getPathAt(float t);
-    QVector3D getPathDtAt(float t);
-    QVector3D getPathDt2At(float t);
-    QVector3D getPathDt3At(float t);
-    QVector3D getPathDt4At(float t);
-
-    QQuaternion calcAxisRotationAt(float t);
-    QVector3D getAxisAt(float t);
-    QVector3D getAxisDtAt(float t);
-    QVector3D getAxisDt2At(float t);
-    QVector3D getAxisDt3At(float t);
-    QVector3D getAxisDt4At(float t);
+    void prepareRows();
+    void computeRow(int tIdx);
+    void publishBoundaries(int tIdx) const;
+    void finishRows();
+    inline int gridIndex(int tIdx, int aIdx) const { return tIdx * (gridSectorsA + 1) + aIdx; }
+
+    void copyDefinition(const Envelope &other, Tool *tool, const QVector<Envelope*> &envelopes);
+    void adoptMeshes(Envelope &computed);
+
+    QVector3D getEnvelopeAt(float t, float a) const;
+    QVector3D getEnvelopeDtAt(float t, float a) const;
+    QVector3D getEnvelopeDt2At(float t, float a) const;
+    QVector3D getEnvelopeDt3At(float t, float a) const;
+    QVector3D getEnvelopeAt(const EnvelopeFrame &frame, float a) const;
+    QVector3D getEnvelopeDtAt(const EnvelopeFrame &frame, float a) const;
+    QVector3D getEnvelopeDt2At(const EnvelopeFrame &frame, float a) const;
+    QVector3D getEnvelopeDt3At(const EnvelopeFrame &frame, float a) const;
+
+    QVector3D getNormalAt(float t, float a) const;
+    QVector3D getNormalDtAt(float t, float a) const;
+    QVector3D getNormalDt2At(float t, float a) const;
+    QVector3D getNormalDt3At(float t, float a) const;
+    QVector3D getNormalAt(const EnvelopeFrame &frame, float a) const;
+    QVector3D getNormalDtAt(const EnvelopeFrame &frame, float a) const;
+    QVector3D getNormalDt2At(const EnvelopeFrame &frame, float a) const;
+    QVector3D getNormalDt3At(const EnvelopeFrame &frame, float a) const;
+
+    EnvelopeJet evaluateJet(float t, float a, int order) const;
+    EnvelopeJet evaluateJet(const EnvelopeFrame &frame, float a, int order) const;
+    EnvelopeJet evaluateJetTaylor(const EnvelopeFrame &frame, float a, int order) const;
+    template<int N> EnvelopeJet evaluateJetTaylor(const EnvelopeFrame &frame, float a) const;
+    EnvelopeFrame computeFrameAt(float t, int order) const;
+    int getAdjacentOrder(int order) const;
+    BoundarySample getBoundaryAt(float t, float a, int order) const;
+
+    QVector3D getPathAt(float t) const;
+    QVector3D getPathDtAt(float t) const;
+    QVector3D getPathDt2At(float t) const;
+    QVector3D getPathDt3At(float t) const;
+    QVector3D getPathDt4At(float t) const;
+
+    QQuaternion calcAxisRotationAt(float t) const;
+    QVector3D getAxisAt(float t) const;
+    QVector3D getAxisDtAt(float t) const;
+    QVector3D getAxisDt2At(float t) const;
+    QVector3D getAxisDt3At(float t) const;
+    QVector3D getAxisDt4At(float t) const;
 
 
 
     inline bool isActive() { return active; }
     inline void setActive(bool value) { active = value; }
 
-    inline bool isPositContinuous() { return adjEnvA0 != nullptr; }
+    inline bool isPositContinuous() const { return adjEnvA0 != nullptr; }
     inline void setTanContinuity(bool value){ tanContToAdj = value; }
     inline bool getTanContinuity() { return tanContToAdj; }
-    inline bool isTanContinuous() { return !isAxisConstrained() && isPositContinuous() && tanContToAdj; }
-    inline bool isAxisConstrained() {return isPositContinuous() && adjEnvA1 != nullptr; }
+    inline bool isTanContinuous() const { return !isAxisConstrained() && isPositContinuous() && tanContToAdj; }
+    inline bool isAxisConstrained() const {return isPositContinuous() && adjEnvA1 != nullptr; }
 
 
     inline bool setAxes(QVector3D axisA0, QVector3D axisA1) { return toolMovement.setAxisDirections(axisA0, axisA1); }
@@ -110,15 +162,41 @@ public:
     inline double getAdjAxisAngle2() const { return adjAxisAngle2; }
 
     inline CylinderMovement& getToolMovement() { return toolMovement; }
-    inline Tool* getTool(){ return tool; }
+    inline Tool* getTool() const { return tool; }
     inline void setTool(Tool *tool) { this->tool = tool; }
 
-    inline QVector<Vertex>& getVertexArr(){ return vertexArr; }
-    inline QVector<Vertex>& getVertexArrCenters(){ return vertexArrCenters; }
-    inline QVector<Vertex>& getVertexArrGrazingCurve(){ return vertexArrGrazingCurve; }
-    inline QVector<QVector<Vertex>>& getVertexArrNormals() { return vertexArrNormals; }
-
-    QMatrix4x4 getToolTransformAt(float t);
+    inline QVector<EnvelopeVertex>& getVertexArr(){ return vertexArr; }
+    inline QVector<unsigned int>& getIndexArr(){ return indexArr; }
+    inline const QVector<EnvelopeVertex>& getVertexArr() const { return vertexArr; }
+    inline const QVector<unsigned int>& getIndexArr() const { return indexArr; }
+    inline int getGridSectorsA() const { return gridSectorsA; }
+    inline int getGridSectorsT() const { return gridSectorsT; }
+    // Row of the sampled grid nearest to t, which has fewer rows than the sectors while the mesh is coarse
+    inline int getGridRowAt(float t) const { return qRound(t * gridSectorsT); }
+    void sampleGrid();
+    inline const QVector<QVector3D>& getGridPositions() const { return gridPositions; }
+    inline const QVector<QVector3D>& getGridNormals() const { return gridNormals; }
+    QVector2D getVertexParamsAt(int i) const;
+    QVector<Vertex>& getVertexArrCenters();
+    QVector<Vertex>& getVertexArrGrazingCurve();
+    QVector<Vertex>& getVertexArrNormalsAt(int gridRow);
+
+    QMatrix4x4 getToolTransformAt(float t) const;
+
+private:
+    void forEachRow(const std::function<void(int)> &rowFunction) const;
+    void computeRows();
+    void sampleGridRow(int tIdx, const EnvelopeFrame &frame);
+    void computeEnvelopeRow(int tIdx);
+    void computeToolCenters();
+    void computeGrazingCurves();
+    void computeNormals(int tIdx);
+    QQuaternion calcAxisRotation(const QVector3D &adjNormal, const QVector3D &adjAxis, float t) const;
+    QVector3D getConstrainedAxis(const QVector3D *x0, const QVector3D *x1) const;
+    QVector3D getConstrainedAxisDt(const QVector3D *x0, const QVector3D *x1) const;
+    QVector3D getPositContPath(const QVector3D *adjEnv, const QVector3D *axis) const;
+    QVector3D getPositContPathDt(const QVector3D *adjEnv, const QVector3D *axis) const;
+    QVector3D getPositContPathDt2(const QVector3D *adjEnv, const QVector3D *axis) const;
 };
 
 #endif // ENVELOPE_H
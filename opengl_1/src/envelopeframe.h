@@ -0,0 +1,21 @@
+#ifndef ENVELOPEFRAME_H
+#define ENVELOPEFRAME_H
+
+#include <QVector3D>
+
+/**
+ * @brief The EnvelopeFrame struct holds everything of an envelope that depends only on t:
+ * the path and the axis, together with their t-derivatives up to the given order.
+ * Index k of each array holds the k-th derivative.
+ */
+struct EnvelopeFrame {
+    static constexpr int MAX_ORDER = 4;
+
+    float t = 0;
+    int order = 0;
+
+    QVector3D path[MAX_ORDER + 1];
+    QVector3D axis[MAX_ORDER + 1];
+};
+
+#endif // ENVELOPEFRAME_H
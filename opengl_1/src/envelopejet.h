@@ -0,0 +1,21 @@
+#ifndef ENVELOPEJET_H
+#define ENVELOPEJET_H
+
+#include <QVector3D>
+
+/**
+ * @brief The EnvelopeJet struct holds the position and the normal of an envelope at one (t,a),
+ * together with their t-derivatives up to the given order. Index k of each array holds the k-th derivative.
+ */
+struct EnvelopeJet {
+    static constexpr int MAX_ORDER = 3;
+
+    float t = 0;
+    float a = 0;
+    int order = 0;
+
+    QVector3D position[MAX_ORDER + 1];
+    QVector3D normal[MAX_ORDER + 1];
+};
+
+#endif // ENVELOPEJET_H
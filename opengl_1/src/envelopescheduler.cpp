@@ -0,0 +1,182 @@
+#include "envelopescheduler.h"
+#include "logging.h"
+#include "profiler.h"
+#include <QHash>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief EnvelopeScheduler::EnvelopeScheduler Creates a scheduler that runs its updates on the given pool.
+ * @param pool Thread pool.
+ */
+EnvelopeScheduler::EnvelopeScheduler(TaskPool *pool) :
+    pool(pool)
+{
+
+}
+
+/**
+ * @brief EnvelopeScheduler::topologicalOrder Orders the envelopes so that every envelope comes after the envelopes of the set it is adjacent to.
+ * @param envelopes Envelopes to order.
+ * @param children Filled with, for each envelope, the indices of the envelopes of the set adjacent to it.
+ * @param numParents Filled with, for each envelope, the number of envelopes of the set it is adjacent to.
+ * @return Indices into envelopes in dependency order. Shorter than envelopes if the dependencies are circular.
+ */
+QVector<int> EnvelopeScheduler::topologicalOrder(const QVector<Envelope*> &envelopes, QVector<QVector<int>> &children, QVector<int> &numParents)
+{
+    int n = envelopes.size();
+    QHash<Envelope*, int> nodeOf;
+    for (int i = 0; i < n; i++) nodeOf[envelopes[i]] = i;
+
+    children = QVector<QVector<int>>(n);
+    numParents = QVector<int>(n, 0);
+    for (int i = 0; i < n; i++) {
+        QVector<Envelope*> parents;
+        Envelope *adjA0 = envelopes[i]->getAdjA0Envelope();
+        Envelope *adjA1 = envelopes[i]->getAdjA1Envelope();
+        if (adjA0 != nullptr) parents.append(adjA0);
+        if (adjA1 != nullptr && adjA1 != adjA0) parents.append(adjA1);
+        for (Envelope *parent : parents) {
+            if (!nodeOf.contains(parent)) continue;
+            children[nodeOf[parent]].append(i);
+            numParents[i]++;
+        }
+    }
+
+    QVector<int> order;
+    QVector<int> remaining(numParents);
+    for (int i = 0; i < n; i++) {
+        if (remaining[i] == 0) order.append(i);
+    }
+    for (int k = 0; k < order.size(); k++) {
+        for (int child : children[order[k]]) {
+            if (--remaining[child] == 0) order.append(child);
+        }
+    }
+    return order;
+}
+
+/**
+ * @brief EnvelopeScheduler::update Updates all given envelopes. Blocks until they are done.
+ * @param envelopes Envelopes to update.
+ */
+void EnvelopeScheduler::update(const QVector<Envelope*> &envelopes)
+{
+    int n = envelopes.size();
+    QVector<QVector<int>> children;
+    QVector<int> numParents;
+    QVector<int> order = topologicalOrder(envelopes, children, numParents);
+
+    if (order.size() < n) {
+        qCWarning(lcCompute) << "Circular envelope dependencies, updating in arbitrary order";
+        for (Envelope *env : envelopes) {
+            if (isCancelled()) return;
+            env->update();
+        }
+        return;
+    }
+    if (!parallel || n <= 1) {
+        for (int i : order) {
+            if (isCancelled()) return;
+            envelopes[i]->update();
+        }
+        return;
+    }
+
+    if (pipelined) updateRows(envelopes, children);
+    else updateEnvelopes(envelopes, children, numParents);
+}
+
+/**
+ * @brief EnvelopeScheduler::updateEnvelopes Updates every envelope as a whole, as soon as the last envelope it is adjacent to is done.
+ */
+void EnvelopeScheduler::updateEnvelopes(const QVector<Envelope*> &envelopes, const QVector<QVector<int>> &children, const QVector<int> &numParents)
+{
+    int n = envelopes.size();
+    std::vector<std::atomic<int>> remaining(n);
+    for (int i = 0; i < n; i++) remaining[i] = numParents[i];
+    TaskGroup group(pool);
+    std::function<void(int)> run = [&](int i) {
+        if (!isCancelled()) envelopes[i]->update();
+        for (int child : children[i]) {
+            if (--remaining[child] == 0) group.run([&run, child] { run(child); }, "envelope");
+        }
+    };
+    for (int i = 0; i < n; i++) {
+        if (numParents[i] == 0) group.run([&run, i] { run(i); }, "envelope");
+    }
+    group.wait();
+}
+
+/**
+ * @brief EnvelopeScheduler::updateRows Updates the envelopes row by row. A row of an envelope starts as soon as the rows at the same t
+ * of the envelopes it is adjacent to are done, and those rows leave their boundaries cached for it.
+ */
+void EnvelopeScheduler::updateRows(const QVector<Envelope*> &envelopes, const QVector<QVector<int>> &children)
+{
+    // Timed as a whole, rows are too short to lock the profiler for each
+    ProfileScope scope("scheduler/updateRows");
+    int n = envelopes.size();
+
+    // The rows of all envelopes are numbered consecutively, starting at firstRow of their envelope
+    QVector<int> firstRow(n + 1, 0);
+    for (int i = 0; i < n; i++) firstRow[i + 1] = firstRow[i] + envelopes[i]->getSectorsT() + 1;
+    int numRows = firstRow[n];
+
+    // No row may read a boundary that was cached before the change, so invalidate them all up front instead of per envelope
+    for (Envelope *env : envelopes) {
+        env->invalidateBoundaries();
+        env->prepareRows();
+    }
+
+    QVector<int> envelopeOf(numRows);
+    QVector<QVector<int>> nextRows(numRows);
+    std::vector<std::atomic<int>> remaining(numRows);
+    for (int i = 0; i < n; i++) {
+        for (int row = firstRow[i]; row < firstRow[i + 1]; row++) {
+            envelopeOf[row] = i;
+            remaining[row] = 0;
+        }
+    }
+    for (int parent = 0; parent < n; parent++) {
+        int parentSectors = envelopes[parent]->getSectorsT();
+        for (int child : children[parent]) {
+            int childSectors = envelopes[child]->getSectorsT();
+            for (int tIdx = 0; tIdx <= childSectors; tIdx++) {
+                // First row of the parent at or after the t of the child row
+                int parentIdx = (tIdx * parentSectors + childSectors - 1) / childSectors;
+                nextRows[firstRow[parent] + parentIdx].append(firstRow[child] + tIdx);
+                remaining[firstRow[child] + tIdx]++;
+            }
+        }
+    }
+
+    TaskGroup group(pool);
+    std::function<void(int)> run = [&](int row) {
+        int i = envelopeOf[row];
+        int tIdx = row - firstRow[i];
+        if (!isCancelled()) {
+            envelopes[i]->computeRow(tIdx);
+            if (!children[i].isEmpty()) envelopes[i]->publishBoundaries(tIdx);
+        }
+        for (int next : nextRows[row]) {
+            if (--remaining[next] == 0) group.run([&run, next] { run(next); }, "envelope row");
+        }
+    };
+    QVector<int> firstRows;
+    for (int row = 0; row < numRows; row++) {
+        if (remaining[row] == 0) firstRows.append(row);
+    }
+    for (int row : firstRows) {
+        group.run([&run, row] { run(row); }, "envelope row");
+    }
+    group.wait();
+
+    // Adaptive meshes need all rows of their envelope
+    if (isCancelled()) return;
+    for (Envelope *env : envelopes) {
+        if (env->getTolerance() > 0) group.run([env] { env->finishRows(); }, "envelope mesh");
+    }
+    group.wait();
+}
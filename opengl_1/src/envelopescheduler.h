@@ -0,0 +1,41 @@
+#ifndef ENVELOPESCHEDULER_H
+#define ENVELOPESCHEDULER_H
+
+#include <QVector>
+#include <atomic>
+#include "envelope.h"
+#include "taskpool.h"
+
+/**
+ * @brief The EnvelopeScheduler class updates a set of envelopes in the order of their dependencies.
+ * An envelope is only updated once the envelopes it is adjacent to are done, while independent envelopes
+ * are updated concurrently on the task pool. When pipelined, the unit of work is a t row instead of a whole envelope,
+ * and a row of a dependent envelope starts as soon as the row of its adjacent envelopes at the same t is done.
+ * An update can be cancelled through a flag, which is checked before every envelope, or every row when pipelined.
+ */
+class EnvelopeScheduler
+{
+    TaskPool *pool;
+    bool parallel = true;
+    bool pipelined = true;
+    const std::atomic<bool> *cancelFlag = nullptr;
+
+public:
+    EnvelopeScheduler(TaskPool *pool = TaskPool::instance());
+
+    inline void setParallel(bool value) { parallel = value; }
+    inline bool isParallel() const { return parallel; }
+    inline void setPipelined(bool value) { pipelined = value; }
+    inline bool isPipelined() const { return pipelined; }
+    inline void setCancelFlag(const std::atomic<bool> *flag) { cancelFlag = flag; }
+    inline bool isCancelled() const { return cancelFlag != nullptr && cancelFlag->load(std::memory_order_relaxed); }
+
+    void update(const QVector<Envelope*> &envelopes);
+    static QVector<int> topologicalOrder(const QVector<Envelope*> &envelopes, QVector<QVector<int>> &children, QVector<int> &numParents);
+
+private:
+    void updateEnvelopes(const QVector<Envelope*> &envelopes, const QVector<QVector<int>> &children, const QVector<int> &numParents);
+    void updateRows(const QVector<Envelope*> &envelopes, const QVector<QVector<int>> &children);
+};
+
+#endif // ENVELOPESCHEDULER_H
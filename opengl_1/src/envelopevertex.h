@@ -0,0 +1,42 @@
+#ifndef ENVELOPEVERTEX_H
+#define ENVELOPEVERTEX_H
+
+#include <QVector3D>
+#include <QtGlobal>
+#include <cmath>
+
+/**
+ * @brief The EnvelopeVertex struct is a vertex of an envelope mesh: its position and its normal, which the shader computes the color from.
+ * The normal is packed as three signed normalized 10 bit components, the layout of GL_INT_2_10_10_10_REV, so a vertex takes 16 bytes.
+ */
+struct EnvelopeVertex {
+    float xCoord;
+    float yCoord;
+    float zCoord;
+    quint32 normal;
+    public:
+    EnvelopeVertex() : xCoord(0.0), yCoord(0.0), zCoord(0.0), normal(0) {}
+    EnvelopeVertex(QVector3D position, QVector3D normal)
+        : xCoord(position.x()), yCoord(position.y()), zCoord(position.z()), normal(pack(normal)) {}
+    QVector3D getPosition() const { return QVector3D(xCoord, yCoord, zCoord); }
+    QVector3D getNormal() const { return QVector3D(unpack(normal, 0), unpack(normal, 10), unpack(normal, 20)); }
+
+private:
+    static inline quint32 pack(QVector3D normal) {
+        quint32 packed = 0;
+        int shift = 0;
+        for (float c : {normal.x(), normal.y(), normal.z()}) {
+            int value = std::isfinite(c) ? (int) std::lround(qBound(-1.0f, c, 1.0f) * 511) : 0;
+            packed |= ((quint32) value & 0x3ff) << shift;
+            shift += 10;
+        }
+        return packed;
+    }
+    // Sign extends the component and maps it to [-1, 1] like OpenGL does
+    static inline float unpack(quint32 packed, int shift) {
+        int value = (qint32) (packed << (22 - shift)) >> 22;
+        return qMax(value / 511.0f, -1.0f);
+    }
+};
+
+#endif // ENVELOPEVERTEX_H
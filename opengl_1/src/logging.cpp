@@ -0,0 +1,7 @@
+#include "logging.h"
+
+Q_LOGGING_CATEGORY(lcRender, "cylinders.render", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcUi, "cylinders.ui", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcInput, "cylinders.input", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcGl, "cylinders.gl", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcCompute, "cylinders.compute", QtInfoMsg)
@@ -0,0 +1,23 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+
+/*
+ * Categories of the debug messages of the subsystems, logged with qCDebug. Their debug messages are off by default, and are turned on
+ * per category at runtime with the --log option or QT_LOGGING_RULES, e.g. QT_LOGGING_RULES="cylinders.render.debug=true".
+ * A disabled qCDebug does not evaluate its arguments. Release builds define QT_NO_DEBUG_OUTPUT, which removes them altogether.
+ */
+
+// Buffer updates and draw calls of the renderers, every frame
+Q_DECLARE_LOGGING_CATEGORY(lcRender)
+// Slots of the main window, on every edit
+Q_DECLARE_LOGGING_CATEGORY(lcUi)
+// Keyboard and mouse events of the main view
+Q_DECLARE_LOGGING_CATEGORY(lcInput)
+// OpenGL initialization and the messages of the debug logger
+Q_DECLARE_LOGGING_CATEGORY(lcGl)
+// Computing envelopes and their dependencies
+Q_DECLARE_LOGGING_CATEGORY(lcCompute)
+
+#endif // LOGGING_H
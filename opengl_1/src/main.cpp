@@ -1,7 +1,10 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QLoggingCategory>
 #include <QSurfaceFormat>
 
 #include "mainwindow.h"
+#include "taskpool.h"
 
 /**
  * @brief main Entry point of the application. Do not modify this file, as it
@@ -13,6 +16,22 @@
 int main(int argc, char *argv[]) {
   QApplication a(argc, argv);
 
+  QCommandLineParser parser;
+  parser.addHelpOption();
+  QCommandLineOption threadsOption("threads", "Number of worker threads of the task pool, 0 for one per core.", "count", "0");
+  QCommandLineOption logOption("log", "Comma separated categories to log debug messages of, e.g. cylinders.render,cylinders.ui.", "categories");
+  parser.addOption(threadsOption);
+  parser.addOption(logOption);
+  parser.process(a);
+  TaskPool::instance()->setThreadCount(parser.value(threadsOption).toInt());
+  if (parser.isSet(logOption)) {
+    QString rules;
+    for (const QString &category : parser.value(logOption).split(',', Qt::SkipEmptyParts)) {
+      rules += category.trimmed() + ".debug=true\n";
+    }
+    QLoggingCategory::setFilterRules(rules);
+  }
+
   // Request OpenGL 4.1 Core
   QSurfaceFormat glFormat;
   glFormat.setProfile(QSurfaceFormat::CoreProfile);
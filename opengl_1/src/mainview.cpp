@@ -3,7 +3,13 @@
 #include "vertex.h"
 
 #include <QDateTime>
+#include <QFontDatabase>
 #include <QOpenGLVersionFunctionsFactory>
+#include <QPainter>
+#include "logging.h"
+#include "profiler.h"
+#include "scene.h"
+#include "taskpool.h"
 
 /**
  * @brief MainView::MainView Constructs a new main view.
@@ -12,9 +18,12 @@
  */
 MainView::MainView(QWidget *parent) : QOpenGLWidget(parent)
 {
-    qDebug() << "MainView constructor";
+    qCDebug(lcUi) << "MainView constructor";
 
     connect(&timer, SIGNAL(timeout()), this, SLOT(update()));
+    connect(&meshWorker, SIGNAL(finished()), this, SLOT(update()));
+    refineTimer.setSingleShot(true);
+    connect(&refineTimer, SIGNAL(timeout()), this, SLOT(update()));
 }
 
 /**
@@ -27,7 +36,7 @@ MainView::MainView(QWidget *parent) : QOpenGLWidget(parent)
  */
 MainView::~MainView()
 {
-    qDebug() << "MainView destructor";
+    qCDebug(lcUi) << "MainView destructor";
     indicesUsed.clear();
     indicesUsed.squeeze();
     for (auto i : toolRenderers){
@@ -85,11 +94,24 @@ Envelope* MainView::addNewEnvelope() {
                                  Polynomial(0,0,0,0),
                                  Polynomial(0,0,1,0));
     Envelope *env = new Envelope(idx, cyl, path);
+    env->setParallel(settings.parallelMeshes);
+    env->setTolerance(settings.tessellationTolerance);
     env->initEnvelope();
     envelopes[idx] = env;
 
+    attachEnvelope(idx);
+    return env;
+}
+
+/**
+ * @brief MainView::attachEnvelope Hands the envelope, tools and path at an index to their renderers and marks the index as used.
+ * @param idx Index of the envelope.
+ */
+void MainView::attachEnvelope(int idx) {
+    Envelope *env = envelopes[idx];
+
     // Set related renderers
-    toolRenderers[idx]->setTool(cyl);
+    toolRenderers[idx]->setTool(env->getTool());
     toolRenderers[idx]->setModelTransf(modelTransf);
     toolRenderers[idx]->setProjTransf(projTransf);
 
@@ -103,7 +125,125 @@ Envelope* MainView::addNewEnvelope() {
 
     // Activate
     indicesUsed[idx] = true;
-    return env;
+}
+
+/**
+ * @brief MainView::describeScene Returns the definition of all envelopes, which can be saved to a scene file.
+ * Envelopes are numbered in the order of their indices, skipping unused ones.
+ */
+SceneDescription MainView::describeScene() const {
+    SceneDescription description;
+    description.sectorsA = settings.aSectors;
+    description.sectorsT = settings.tSectors;
+    description.tolerance = settings.tessellationTolerance;
+
+    QVector<int> sceneIdx(envelopes.size(), -1);
+    for (int i = 0; i < envelopes.size(); i++) {
+        if (!indicesUsed[i]) continue;
+        sceneIdx[i] = description.envelopes.size();
+        description.envelopes.append(EnvelopeDescription());
+    }
+    for (int i = 0; i < envelopes.size(); i++) {
+        if (!indicesUsed[i]) continue;
+        Envelope *env = envelopes[i];
+        EnvelopeDescription &envDesc = description.envelopes[sceneIdx[i]];
+        envDesc.active = env->isActive();
+        envDesc.toolType = env->getTool()->getType();
+        // Both tools of an index share their radius and height
+        envDesc.radius = cylinders[i]->getRadius();
+        envDesc.angle = cylinders[i]->getAngle();
+        envDesc.curvatureRadius = drums[i]->getCurvatureRadius();
+        envDesc.height = cylinders[i]->getHeight();
+        Scene::describeEnvelope(*env, envDesc);
+        if (envDesc.adjacentA0 != -1) envDesc.adjacentA0 = sceneIdx[envDesc.adjacentA0];
+        if (envDesc.adjacentA1 != -1) envDesc.adjacentA1 = sceneIdx[envDesc.adjacentA1];
+    }
+    return description;
+}
+
+/**
+ * @brief MainView::loadScene Replaces all envelopes by the described ones and requests their meshes from the worker. Meshes that
+ * are being computed for the previous envelopes are dropped.
+ * @param error Set to a description of the problem if the scene cannot be shown.
+ * @return False if the scene is invalid or has more envelopes than can be shown, in which case the current envelopes are kept.
+ */
+bool MainView::loadScene(const SceneDescription &description, QString &error) {
+    if (description.envelopes.size() > (qsizetype) settings.NUM_ENVELOPES) {
+        error = QString("the scene has %1 envelopes, but at most %2 can be shown").arg(description.envelopes.size()).arg(settings.NUM_ENVELOPES);
+        return false;
+    }
+    if (!description.validate(error)) return false;
+
+    meshJobs.reset();
+    meshCoarsening.clear();
+    for (int i = 0; i < envelopes.size(); i++) {
+        delete envelopes[i];
+        delete cylinders[i];
+        delete drums[i];
+        envelopes[i] = nullptr;
+        cylinders[i] = nullptr;
+        drums[i] = nullptr;
+        indicesUsed[i] = false;
+    }
+    settings.aSectors = description.sectorsA;
+    settings.tSectors = description.sectorsT;
+    settings.tessellationTolerance = description.tolerance;
+    settings.aIdx = std::min(settings.aIdx, settings.aSectors);
+    settings.timeIdx = std::min(settings.timeIdx, settings.tSectors);
+
+    QVector<Envelope*> loaded;
+    for (int idx = 0; idx < description.envelopes.size(); idx++) {
+        const EnvelopeDescription &envDesc = description.envelopes[idx];
+        Cylinder *cyl = new Cylinder();
+        cyl->setRadius(envDesc.radius);
+        cyl->setAngle(envDesc.angle);
+        cyl->setHeight(envDesc.height);
+        cyl->setSectors(envDesc.sectorsA);
+        cylinders[idx] = cyl;
+        Drum *drum = new Drum();
+        drum->setRadius(envDesc.radius);
+        drum->setCurvatureRadius(envDesc.curvatureRadius);
+        drum->setHeight(envDesc.height);
+        drum->setSectors(envDesc.sectorsA);
+        drums[idx] = drum;
+
+        const float (*p)[4] = envDesc.path;
+        SimplePath path(Polynomial(p[0][0], p[0][1], p[0][2], p[0][3]),
+                        Polynomial(p[1][0], p[1][1], p[1][2], p[1][3]),
+                        Polynomial(p[2][0], p[2][1], p[2][2], p[2][3]));
+        path.setSectors(envDesc.sectorsT);
+        Tool *tool = envDesc.toolType == Tool_Drum ? (Tool*) drum : (Tool*) cyl;
+        Envelope *env = new Envelope(idx, tool, path);
+        env->setSectorsA(envDesc.sectorsA);
+        env->setSectorsT(envDesc.sectorsT);
+        env->setParallel(settings.parallelMeshes);
+        env->setTolerance(envDesc.tolerance);
+        env->setAxes(envDesc.axisA0, envDesc.axisA1);
+        env->setTanContinuity(envDesc.tangentContinuous);
+        env->setAdjacentAxisAngles(envDesc.axisAngle1, envDesc.axisAngle2);
+        envelopes[idx] = env;
+        loaded.append(env);
+    }
+    for (int idx = 0; idx < loaded.size(); idx++) {
+        const EnvelopeDescription &envDesc = description.envelopes[idx];
+        if (envDesc.adjacentA0 != -1) loaded[idx]->setAdjacentA0Envelope(loaded[envDesc.adjacentA0]);
+        if (envDesc.adjacentA1 != -1) loaded[idx]->setAdjacentA1Envelope(loaded[envDesc.adjacentA1]);
+    }
+
+    // The meshes are computed by the worker like those of edits, nothing is drawn for the new envelopes until then
+    for (int idx = 0; idx < loaded.size(); idx++) {
+        loaded[idx]->setActive(description.envelopes[idx].active);
+        attachEnvelope(idx);
+        toolTransfUpdates += idx;
+        meshJobs.request(idx, MeshJobQueue::EnvelopeMesh);
+        meshJobs.request(idx, MeshJobQueue::ToolMesh);
+    }
+
+    settings.selectedIdx = -1;
+    updateBuffers();
+    updateAllUniforms = true;
+    update();
+    return true;
 }
 
 /**
@@ -111,7 +251,7 @@ Envelope* MainView::addNewEnvelope() {
  * @param env
  */
 void MainView::deleteEnvelope(Envelope *env) {
-    qDebug() << "TODO";
+    qCDebug(lcUi) << "TODO";
 }
 
 // --- OpenGL initialization
@@ -122,7 +262,7 @@ void MainView::deleteEnvelope(Envelope *env) {
  */
 void MainView::initializeGL()
 {
-    qDebug() << ":: Initializing OpenGL";
+    qCDebug(lcGl) << ":: Initializing OpenGL";
     initializeOpenGLFunctions();
 
     connect(&debugLogger, SIGNAL(messageLogged(QOpenGLDebugMessage)), this,
@@ -130,12 +270,12 @@ void MainView::initializeGL()
 
     if (debugLogger.initialize())
     {
-        qDebug() << ":: Logging initialized";
+        qCDebug(lcGl) << ":: Logging initialized";
         debugLogger.startLogging(QOpenGLDebugLogger::SynchronousLogging);
     }
 
     QString glVersion{reinterpret_cast<const char *>(glGetString(GL_VERSION))};
-    qDebug() << ":: Using OpenGL" << qPrintable(glVersion);
+    qCDebug(lcGl) << ":: Using OpenGL" << qPrintable(glVersion);
 
     // Enable depth buffer
     glEnable(GL_DEPTH_TEST);
@@ -206,7 +346,8 @@ void MainView::initializeGL()
  * TODO: extend to update buffer of other cylinders and enveloping surfaces.
  */
 void MainView::updateBuffers(){
-    qDebug() << "main update buffers";
+    qCDebug(lcRender) << "main update buffers";
+    ProfileScope scope("view/updateBuffers");
 
     for (int i = 0; i < indicesUsed.size(); i++) {
         if (!indicesUsed[i]) continue;
@@ -217,7 +358,8 @@ void MainView::updateBuffers(){
 }
 
 void MainView::updateUniforms() {
-    qDebug() << "main update uniforms";
+    qCDebug(lcRender) << "main update uniforms";
+    ProfileScope scope("view/updateUniforms");
 
     for (int i = 0; i < indicesUsed.size(); i++) {
         if (!indicesUsed[i]) continue;
@@ -229,51 +371,115 @@ void MainView::updateUniforms() {
 
 
 /**
- * @brief MainView::paintGL Actual function used for drawing to the screen.
- *
+ * @brief MainView::paintGL Actual function used for drawing to the screen. Draws the scene, and the timings overlay on top if it is shown.
  */
 void MainView::paintGL()
 {
+    {
+        ProfileScope scope("paint/frame");
+        paintScene();
+    }
+    if (settings.showTimings) paintTimings();
+}
+
+/**
+ * @brief MainView::paintScene Takes over finished meshes, requests new ones and draws all envelopes, tools and paths.
+ * Every phase is timed by the profiler. Draw calls are timed as they are issued, not as the GPU executes them.
+ */
+void MainView::paintScene()
+{
+    // The timings overlay is drawn with QPainter, which leaves the OpenGL state changed
+    if (settings.showTimings) {
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LEQUAL);
+        glDisable(GL_BLEND);
+    }
+
     // Clear the screen before rendering
     gl->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    if (!envelopeMeshUpdates.isEmpty()) {
-        QList<int> indices = envelopeMeshUpdates.values();
-        while (!indices.isEmpty()) {
-            int i = indices.takeFirst();
-            envelopes[i]->update();
+    // Edited envelopes keep their previous meshes until the worker is done, but their cached boundaries are outdated already
+    for (int i : meshJobs.getPending(MeshJobQueue::EnvelopeMesh)) {
+        envelopes[i]->invalidateBoundaries();
+    }
+
+    // Meshes computed from definitions that were edited since are dropped, and requested again
+    if (meshJobs.isStale()) meshWorker.cancel();
+    if (meshWorker.isDone()) {
+        QSet<int> envelopeIndices;
+        QSet<int> toolIndices;
+        bool completed;
+        {
+            ProfileScope scope("paint/collectMeshes");
+            completed = meshWorker.collect(envelopes, cylinders, drums, envelopeIndices, toolIndices);
+        }
+        meshJobs.finish(completed);
+        ProfileScope scope("paint/bufferUploads");
+        for (int i : envelopeIndices) {
+            if (meshWorker.getCoarsening() > 1) {
+                meshCoarsening.insert(i, meshWorker.getCoarsening());
+            } else {
+                meshCoarsening.remove(i);
+            }
             envelopeRenderers[i]->updateBuffers();
             moveRenderers[i]->updateBuffers();
         }
-        envelopeMeshUpdates.clear();
+        for (int i : toolIndices) {
+            toolRenderers[i]->updateBuffers();
+        }
+        qCDebug(lcRender) << "Mesh jobs:" << meshJobs.getNumCompleted() << "completed," << meshJobs.getNumCancelled() << "cancelled,"
+                          << meshJobs.getNumCoalesced() << "of" << meshJobs.getNumRequested() << "requests coalesced";
     }
 
-    if (!toolMeshUpdates.isEmpty()) {
-        QList<int> indices = toolMeshUpdates.values();
-        while (!indices.isEmpty()) {
-            int i = indices.takeFirst();
-            cylinders[i]->update();
-            drums[i]->update();
-            toolRenderers[i]->updateBuffers();
+    // Once the input is idle, meshes shown at a coarse resolution are refined, halving the coarsening with every pass
+    if (!meshCoarsening.isEmpty() && !meshJobs.isRunning() && !meshJobs.hasPending()) {
+        qint64 idle = meshJobs.getMsecsSinceRequest();
+        if (idle >= settings.refineDelay) {
+            QSet<int> coarse;
+            for (auto it = meshCoarsening.constBegin(); it != meshCoarsening.constEnd(); ++it) coarse.insert(it.key());
+            meshJobs.requestRefinement(coarse);
+        } else {
+            refineTimer.start(settings.refineDelay - idle);
         }
-        toolMeshUpdates.clear();
     }
 
-    if (!toolTransfUpdates.isEmpty()) {
-        QList<int> indices = toolTransfUpdates.values();
-        while (!indices.isEmpty()) {
-            int i = indices.takeFirst();
-            toolRenderers[i]->setToolTransf(envelopes[i]->getToolTransformAt(settings.t()));
-            toolRenderers[i]->updateUniforms();
+    // The pool can only be resized while it is idle, which it is while the worker is
+    if (settings.threadCount > 0 && !meshWorker.isBusy()) TaskPool::instance()->setThreadCount(settings.threadCount);
+
+    // Edits made while the worker is busy are collected and submitted together once it is done.
+    // While editing, envelopes are computed coarsely for quick feedback
+    if (meshJobs.hasPending() && !meshWorker.isBusy()) {
+        const QSet<int> &pendingEnvelopes = meshJobs.getPending(MeshJobQueue::EnvelopeMesh);
+        int coarsening = 1;
+        if (meshJobs.getMsecsSinceRequest() < settings.refineDelay) {
+            coarsening = settings.previewCoarsening;
+        } else {
+            for (int i : pendingEnvelopes) coarsening = std::max(coarsening, meshCoarsening.value(i, 1) / 2);
         }
-        toolTransfUpdates.clear();
+        meshWorker.submit(envelopes, cylinders, drums, pendingEnvelopes, meshJobs.getPending(MeshJobQueue::ToolMesh),
+                          settings.parallelEnvelopes, settings.pipelinedEnvelopes, coarsening);
+        meshJobs.start();
     }
 
-    if (updateAllUniforms) {
-        updateUniforms();
-        updateAllUniforms = false;
+    {
+        ProfileScope scope("paint/uniforms");
+        if (!toolTransfUpdates.isEmpty()) {
+            QList<int> indices = toolTransfUpdates.values();
+            while (!indices.isEmpty()) {
+                int i = indices.takeFirst();
+                toolRenderers[i]->setToolTransf(envelopes[i]->getToolTransformAt(settings.t()));
+                toolRenderers[i]->updateUniforms();
+            }
+            toolTransfUpdates.clear();
+        }
+
+        if (updateAllUniforms) {
+            updateUniforms();
+            updateAllUniforms = false;
+        }
     }
 
+    ProfileScope scope("paint/draw");
     for (int i = 0; i < indicesUsed.size(); i++) {
         if (!indicesUsed[i]) continue;
         if (!envelopes[i]->isActive()) continue;
@@ -283,6 +489,31 @@ void MainView::paintGL()
     }
 }
 
+/**
+ * @brief MainView::paintTimings Draws the rolling averages and percentiles of all sections timed by the profiler over the scene.
+ */
+void MainView::paintTimings()
+{
+    QStringList lines;
+    lines.append(QString("%1 %2 %3 %4 %5").arg("section", -32).arg("mean", 8).arg("median", 8).arg("p95", 8).arg("max", 8));
+    for (const Profiler::Statistics &stats : Profiler::instance()->statistics()) {
+        lines.append(QString("%1 %2 %3 %4 %5").arg(stats.name, -32).arg(stats.meanMs, 8, 'f', 3).arg(stats.medianMs, 8, 'f', 3)
+                     .arg(stats.p95Ms, 8, 'f', 3).arg(stats.maxMs, 8, 'f', 3));
+    }
+
+    QPainter painter(this);
+    painter.setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    QFontMetrics metrics = painter.fontMetrics();
+    int width = 0;
+    for (const QString &line : lines) width = std::max(width, metrics.horizontalAdvance(line));
+    QRect box(8, 8, width + 16, lines.size() * metrics.lineSpacing() + 12);
+    painter.fillRect(box, QColor(0, 0, 0, 160));
+    painter.setPen(Qt::white);
+    for (int i = 0; i < lines.size(); i++) {
+        painter.drawText(box.left() + 8, box.top() + 6 + metrics.ascent() + i * metrics.lineSpacing(), lines[i]);
+    }
+}
+
 /**
  * @brief MainView::resizeGL Called upon resizing of the screen.
  *
@@ -291,7 +522,7 @@ void MainView::paintGL()
  */
 void MainView::resizeGL(int newWidth, int newHeight)
 {
-    qDebug() << "MainView::resizeGL";
+    qCDebug(lcRender) << "MainView::resizeGL";
     // Get the aspect ratio of the new screen size
     float aspectRatio = newWidth / ((float)newHeight);
 
@@ -316,8 +547,8 @@ void MainView::resizeGL(int newWidth, int newHeight)
  */
 void MainView::setRotation(int rotateX, int rotateY, int rotateZ)
 {
-    qDebug() << "Rotation changed to (" << rotateX << "," << rotateY << ","
-             << rotateZ << ")";
+    qCDebug(lcUi) << "Rotation changed to (" << rotateX << "," << rotateY << ","
+                  << rotateZ << ")";
 
     // Reset the rotation matrix
     modelRotation.setToIdentity();
@@ -349,7 +580,7 @@ void MainView::setRotation(int rotateX, int rotateY, int rotateZ)
 // TODO remove the update call here and move it to wherever in mainwindow this function is called
 void MainView::setScale(float scale)
 {
-    qDebug() << "Scale changed to " << scale;
+    qCDebug(lcUi) << "Scale changed to " << scale;
 
     // Reset the scale matrix
     modelScaling.setToIdentity();
@@ -389,5 +620,5 @@ void MainView::updateToolTransf(){
  */
 void MainView::onMessageLogged(QOpenGLDebugMessage Message)
 {
-    qDebug() << " → Log:" << Message;
+    qCDebug(lcGl) << " → Log:" << Message;
 }
@@ -1,6 +1,7 @@
 #ifndef MAINVIEW_H
 #define MAINVIEW_H
 
+#include <QHash>
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QOpenGLDebugLogger>
@@ -15,6 +16,9 @@
 #include "movement/cylindermovement.h"
 #include "movement/simplepath.h"
 #include "envelope.h"
+#include "scenedescription.h"
+#include "meshjobqueue.h"
+#include "meshworker.h"
 #include "settings.h"
 #include "renderers/toolrenderer.h"
 #include "renderers/enveloperenderer.h"
@@ -36,8 +40,7 @@ class MainView : public QOpenGLWidget, protected QOpenGLFunctions_4_1_Core
     // If the pool needs to increase, we do so, and keep track in the indicesUsed array for which objects are in use.
     // There are likely optimizations possible to shrink memory usage when possible, but not for now.
 
-    QSet<int> envelopeMeshUpdates;
-    QSet<int> toolMeshUpdates;
+    MeshJobQueue meshJobs;
     QSet<int> toolTransfUpdates;
     bool updateAllUniforms;
 
@@ -53,6 +56,12 @@ class MainView : public QOpenGLWidget, protected QOpenGLFunctions_4_1_Core
     QVector<Envelope*> envelopes;
     QVector<EnvelopeRenderer*> envelopeRenderers;
 
+    // Computes the meshes requested in meshJobs in the background
+    MeshWorker meshWorker;
+    // Coarsening of the shown envelope meshes that are not at full resolution yet, by index
+    QHash<int, int> meshCoarsening;
+    QTimer refineTimer;
+
     // Transformation matrices for the model
     QMatrix4x4 modelScaling;
     QMatrix4x4 modelRotation;
@@ -75,6 +84,12 @@ public:
     Envelope *addNewEnvelope();
     void deleteEnvelope(Envelope *env);
 
+    // Whether every shown mesh is computed at full resolution from the current definitions
+    inline bool hasFinalMeshes() const { return !meshJobs.isRunning() && !meshJobs.hasPending() && meshCoarsening.isEmpty(); }
+
+    SceneDescription describeScene() const;
+    bool loadScene(const SceneDescription &description, QString &error);
+
 protected:
     void initializeGL() override;
     void updateUniforms();
@@ -98,6 +113,10 @@ private slots:
     void onMessageLogged(QOpenGLDebugMessage Message);
 
 private:
+    void attachEnvelope(int idx);
+    void paintScene();
+    void paintTimings();
+
     QOpenGLDebugLogger debugLogger;
     QTimer timer; // timer used for animation
 
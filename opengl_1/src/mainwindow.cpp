@@ -1,6 +1,14 @@
 #include "mainwindow.h"
 
 #include "ui_mainwindow.h"
+#include "logging.h"
+#include "meshexporter.h"
+#include "profiler.h"
+#include "taskpool.h"
+#include <QDir>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QSignalBlocker>
 #include <QStandardItemModel>
 
 /**
@@ -23,6 +31,12 @@ MainWindow::MainWindow(QWidget *parent)
   ui->aSlider->setMaximum(ui->mainView->settings.aSectors);
   ui->TimeSlider->setMaximum(ui->mainView->settings.tSectors);
 
+  // The pool is sized on the command line before the window is created
+  {
+    QSignalBlocker blockThreads(ui->threadsSpinBox);
+    ui->threadsSpinBox->setValue(TaskPool::instance()->getThreadCount());
+  }
+
   updateUI();
 }
 
@@ -93,7 +107,7 @@ void MainWindow::updateUI() {
 void MainWindow::updateUI(int prevIdx) {
     int idx = ui->mainView->settings.selectedIdx;
     // if (idx == prevIdx) {
-    //     qDebug() << ":: ERROR -- UI update for unchanged selection";
+    //     qCDebug(lcUi) << ":: ERROR -- UI update for unchanged selection";
     //     return;
     // }
     QVector<Envelope *> envelopes = ui->mainView->envelopes;
@@ -181,22 +195,22 @@ void MainWindow::updateUI(int prevIdx) {
 /***********************************************************/
 
 void MainWindow::on_envelopeSelectBox_currentIndexChanged(int index) {
-    qDebug() << ":: on_envelopeSelectBox_currentIndexChanged";
+    qCDebug(lcUi) << ":: on_envelopeSelectBox_currentIndexChanged";
     int idx = ui->envelopeSelectBox->itemData(index).value<int>();
     int prevIdx = ui->mainView->settings.selectedIdx;
-    qDebug() << "Selected envelope" << idx;
+    qCDebug(lcUi) << "Selected envelope" << idx;
     ui->mainView->settings.selectedIdx = idx;
 
     updateUI(prevIdx);
 }
 
 void MainWindow::on_envelopeActiveCheckBox_toggled(bool checked) {
-    qDebug() << ":: on_envelopeActiveCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_envelopeActiveCheckBox_toggled";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     if (ui->mainView->envelopes[idx]->isActive() == checked) return;
 
-    qDebug() << "Changed active state of envelope" << idx;
+    qCDebug(lcUi) << "Changed active state of envelope" << idx;
     ui->mainView->envelopes[idx]->setActive(checked);
 
     ui->mainView->update();
@@ -204,7 +218,7 @@ void MainWindow::on_envelopeActiveCheckBox_toggled(bool checked) {
 
 
 void MainWindow::on_constraintA0SelectBox_currentIndexChanged(int index) {
-    qDebug() << ":: on_constraintA0SelectBox_currentIndexChanged";
+    qCDebug(lcUi) << ":: on_constraintA0SelectBox_currentIndexChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     Envelope *envelope = ui->mainView->envelopes[idx];
@@ -219,7 +233,7 @@ void MainWindow::on_constraintA0SelectBox_currentIndexChanged(int index) {
         envelope->setAdjacentA0Envelope(adjEnv);
 
         QSet<int> depEnvs = envelope->getAllDependents();
-        ui->mainView->envelopeMeshUpdates += depEnvs;
+        ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
         ui->mainView->toolTransfUpdates += depEnvs;
         ui->mainView->update();
     }
@@ -235,7 +249,7 @@ void MainWindow::on_constraintA0SelectBox_currentIndexChanged(int index) {
 }
 
 void MainWindow::on_constraintA1SelectBox_currentIndexChanged(int index) {
-    qDebug() << ":: on_constraintA1SelectBox_currentIndexChanged";
+    qCDebug(lcUi) << ":: on_constraintA1SelectBox_currentIndexChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     Envelope *envelope = ui->mainView->envelopes[idx];
@@ -246,7 +260,7 @@ void MainWindow::on_constraintA1SelectBox_currentIndexChanged(int index) {
         envelope->setAdjacentA1Envelope(adjEnv);
 
         QSet<int> depEnvs = envelope->getAllDependents();
-        ui->mainView->envelopeMeshUpdates += depEnvs;
+        ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
         ui->mainView->toolTransfUpdates += depEnvs;
         ui->mainView->update();
     }
@@ -262,13 +276,13 @@ void MainWindow::on_constraintA1SelectBox_currentIndexChanged(int index) {
  * @param checked The new value of the checkbox.
  */
 void MainWindow::on_tanContCheckBox_toggled(bool checked){
-    qDebug() << ":: on_tanContCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_tanContCheckBox_toggled";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     ui->mainView->envelopes[idx]->setTanContinuity(checked);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 
@@ -276,23 +290,112 @@ void MainWindow::on_tanContCheckBox_toggled(bool checked){
 }
 
 void MainWindow::on_newEnvelopeButton_clicked() {
-    qDebug() << ":: on_newEnvelopeButton_clicked";
+    qCDebug(lcUi) << ":: on_newEnvelopeButton_clicked";
     Envelope *env = ui->mainView->addNewEnvelope();
     if (env == nullptr) {
-        qDebug() << "Maximum number of envelopes reached";
+        qCDebug(lcUi) << "Maximum number of envelopes reached";
         return;
     }
     int idx = env->getIndex();
     addEnvToSelectorMenus(env);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->envelopeMeshUpdates += depEnvs;
-    ui->mainView->toolMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->updateAllUniforms = true;
     ui->mainView->update();
 }
 
+/**
+ * @brief MainWindow::on_loadSceneButton_clicked Replaces all envelopes by the ones in a scene file.
+ */
+void MainWindow::on_loadSceneButton_clicked() {
+    qCDebug(lcUi) << ":: on_loadSceneButton_clicked";
+    QString fileName = QFileDialog::getOpenFileName(this, "Load Scene", QString(), "Scenes (*.envs *.json)");
+    if (fileName.isEmpty()) return;
+
+    SceneDescription description;
+    QString errorText;
+    if (!description.load(fileName, errorText) || !ui->mainView->loadScene(description, errorText)) {
+        error.showMessage(QString("Cannot load %1: %2").arg(fileName, errorText));
+        return;
+    }
+
+    // The selectors and sampling settings are rebuilt without triggering their handlers, which would edit the new envelopes
+    {
+        QSignalBlocker blockSelect(ui->envelopeSelectBox);
+        QSignalBlocker blockA0(ui->constraintA0SelectBox);
+        QSignalBlocker blockA1(ui->constraintA1SelectBox);
+        QSignalBlocker blockSectorsA(ui->axisSectorsSpinBox);
+        QSignalBlocker blockSectorsT(ui->timeSectorsSpinBox);
+        QSignalBlocker blockTolerance(ui->toleranceSpinBox);
+        for (QComboBox *box : {ui->envelopeSelectBox, ui->constraintA0SelectBox, ui->constraintA1SelectBox}) {
+            while (box->count() > 1) box->removeItem(1);
+            box->setCurrentIndex(0);
+        }
+        for (int i = 0; i < ui->mainView->envelopes.size(); i++) {
+            if (ui->mainView->indicesUsed[i]) addEnvToSelectorMenus(ui->mainView->envelopes[i]);
+        }
+        ui->axisSectorsSpinBox->setValue(ui->mainView->settings.aSectors);
+        ui->timeSectorsSpinBox->setValue(ui->mainView->settings.tSectors);
+        ui->toleranceSpinBox->setValue(ui->mainView->settings.tessellationTolerance);
+    }
+    ui->aSlider->setMaximum(ui->mainView->settings.aSectors);
+    ui->TimeSlider->setMaximum(ui->mainView->settings.tSectors);
+    updateUI();
+}
+
+/**
+ * @brief MainWindow::on_saveSceneButton_clicked Saves all envelopes to a scene file, as JSON if its name ends in .json.
+ */
+void MainWindow::on_saveSceneButton_clicked() {
+    qCDebug(lcUi) << ":: on_saveSceneButton_clicked";
+    QString fileName = QFileDialog::getSaveFileName(this, "Save Scene", QString(), "Scenes (*.envs);;JSON scenes (*.json)");
+    if (fileName.isEmpty()) return;
+
+    QString errorText;
+    if (!ui->mainView->describeScene().save(fileName, errorText)) {
+        error.showMessage(QString("Cannot save %1: %2").arg(fileName, errorText));
+    }
+}
+
+/**
+ * @brief MainWindow::on_exportMeshesButton_clicked Writes the mesh of every envelope, and of its tool placed at the current time,
+ * to files named after the chosen one. PLY files also hold the (t,a) parameters of the envelope vertices.
+ * Refused while any mesh is shown coarsely or is still being recomputed.
+ */
+void MainWindow::on_exportMeshesButton_clicked() {
+    qCDebug(lcUi) << ":: on_exportMeshesButton_clicked";
+    // Coarse previews and meshes of outdated definitions would be written as if they were final
+    if (!ui->mainView->hasFinalMeshes()) {
+        error.showMessage("The meshes are still being computed, export them once they are done.");
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(this, "Export Meshes", QString(), "PLY meshes (*.ply);;STL meshes (*.stl)");
+    if (fileName.isEmpty()) return;
+
+    MeshExporter::Format format;
+    if (!MeshExporter::formatOf(fileName, format)) fileName += ".ply";
+    QFileInfo info(fileName);
+    QString base = info.dir().filePath(info.completeBaseName());
+    QString suffix = info.suffix();
+
+    MainView *view = ui->mainView;
+    QString errorText;
+    for (int i = 0; i < view->envelopes.size(); i++) {
+        if (!view->indicesUsed[i]) continue;
+        Envelope *env = view->envelopes[i];
+        QString envelopeFile = QString("%1_envelope%2.%3").arg(base).arg(i).arg(suffix);
+        QString toolFile = QString("%1_tool%2.%3").arg(base).arg(i).arg(suffix);
+        if (!MeshExporter::exportEnvelope(*env, envelopeFile, errorText, true)
+            || !MeshExporter::exportTool(*env->getTool(), env->getToolTransformAt(view->settings.t()), toolFile, errorText)) {
+            error.showMessage(QString("Cannot export the meshes of envelope %1: %2").arg(i).arg(errorText));
+            return;
+        }
+    }
+}
+
 /***********************************************************/
 /************************ Tool Menu ************************/
 /***********************************************************/
@@ -301,13 +404,13 @@ void MainWindow::on_newEnvelopeButton_clicked() {
  * @brief MainWindow::on_orientVector_1_returnPressed Updates the orientation vector of the tool.
  */
 void MainWindow::on_orientVector_1_returnPressed(){
-    qDebug() << ":: on_orientVector_1_returnPressed";
+    qCDebug(lcUi) << ":: on_orientVector_1_returnPressed";
     int idx = ui->mainView->settings.selectedIdx;
-    qDebug() << "orientation vector changed";
+    qCDebug(lcUi) << "orientation vector changed";
     QVector3D vector1 = ui->mainView->settings.stringToVector3D(ui->orientVector_1->text());
     QVector3D vector2 = ui->mainView->settings.stringToVector3D(ui->orientVector_2->text());
 
-    qDebug() << "to" << vector1 << "and" << vector2;
+    qCDebug(lcUi) << "to" << vector1 << "and" << vector2;
 
     Envelope *env = ui->mainView->envelopes[idx];
     bool success = env->setAxes(vector1,vector2);
@@ -316,7 +419,7 @@ void MainWindow::on_orientVector_1_returnPressed(){
     }
 
     QSet<int> depEnvs = env->getAllDependents();
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -325,13 +428,13 @@ void MainWindow::on_orientVector_1_returnPressed(){
  * @brief MainWindow::on_orientVector_2_returnPressed Updates the orientation vector of the tool.
  */
 void MainWindow::on_orientVector_2_returnPressed(){
-    qDebug() << ":: on_orientVector_2_returnPressed";
+    qCDebug(lcUi) << ":: on_orientVector_2_returnPressed";
     int idx = ui->mainView->settings.selectedIdx;
-    qDebug() << "orientation vector changed";
+    qCDebug(lcUi) << "orientation vector changed";
     QVector3D vector1 = ui->mainView->settings.stringToVector3D(ui->orientVector_1->text());
     QVector3D vector2 = ui->mainView->settings.stringToVector3D(ui->orientVector_2->text());
 
-    qDebug() << "to" << vector1 << "and" << vector2;
+    qCDebug(lcUi) << "to" << vector1 << "and" << vector2;
 
     Envelope *env = ui->mainView->envelopes[idx];
     bool success = env->setAxes(vector1,vector2);
@@ -340,7 +443,7 @@ void MainWindow::on_orientVector_2_returnPressed(){
     }
 
     QSet<int> depEnvs = env->getAllDependents();
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -351,14 +454,14 @@ void MainWindow::on_orientVector_2_returnPressed(){
  * @param value new angle.
  */
 void MainWindow::on_angleOrient_1_SpinBox_valueChanged(double value) {
-    qDebug() << ":: on_angleOrient_1_SpinBox_valueChanged";
+    qCDebug(lcUi) << ":: on_angleOrient_1_SpinBox_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     Envelope *env = ui->mainView->envelopes[idx];
     env->setAdjacentAxisAngles(value, ui->angleOrient_2_SpinBox->value());
 
     QSet<int> depEnvs = env->getAllDependents();
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -369,14 +472,14 @@ void MainWindow::on_angleOrient_1_SpinBox_valueChanged(double value) {
  * @param value new angle.
  */
 void MainWindow::on_angleOrient_2_SpinBox_valueChanged(double value) {
-    qDebug() << ":: on_angleOrient_2_SpinBox_valueChanged";
+    qCDebug(lcUi) << ":: on_angleOrient_2_SpinBox_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     Envelope *env = ui->mainView->envelopes[idx];
     env->setAdjacentAxisAngles(ui->angleOrient_1_SpinBox->value(), value);
 
     QSet<int> depEnvs = env->getAllDependents();
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -387,15 +490,15 @@ void MainWindow::on_angleOrient_2_SpinBox_valueChanged(double value) {
  * @param value new radius.
  */
 void MainWindow::on_radiusSpinBox_valueChanged(double value) {
-    qDebug() << ":: on_radiusSpinBox_valueChanged";
+    qCDebug(lcUi) << ":: on_radiusSpinBox_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     ui->mainView->cylinders[idx]->setRadius(value);
     ui->mainView->drums[idx]->setRadius(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -405,14 +508,14 @@ void MainWindow::on_radiusSpinBox_valueChanged(double value) {
  * @param value new inner radius.
  */
 void MainWindow::on_drumRadiusSpinBox_valueChanged(double value) {
-    qDebug() << ":: on_drumRadiusSpinBox_valueChanged";
+    qCDebug(lcUi) << ":: on_drumRadiusSpinBox_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     ui->mainView->drums[idx]->setCurvatureRadius(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -422,14 +525,14 @@ void MainWindow::on_drumRadiusSpinBox_valueChanged(double value) {
  * @param value new opening angle.
  */
 void MainWindow::on_angleSpinBox_valueChanged(double value) {
-    qDebug() << ":: on_angleSpinBox_valueChanged";
+    qCDebug(lcUi) << ":: on_angleSpinBox_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     ui->mainView->cylinders[idx]->setAngle(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -439,15 +542,15 @@ void MainWindow::on_angleSpinBox_valueChanged(double value) {
  * @param value new height.
  */
 void MainWindow::on_heightSpinBox_valueChanged(double value) {
-    qDebug() << ":: on_heightSpinBox_valueChanged";
+    qCDebug(lcUi) << ":: on_heightSpinBox_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
     ui->mainView->cylinders[idx]->setHeight(value);
     ui->mainView->drums[idx]->setHeight(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -457,11 +560,11 @@ void MainWindow::on_heightSpinBox_valueChanged(double value) {
  * @param index The index of the tool.
  */
 void MainWindow::on_toolBox_currentIndexChanged(int index){
-    qDebug() << ":: on_toolBox_currentIndexChanged";
+    qCDebug(lcUi) << ":: on_toolBox_currentIndexChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
-    qDebug() << "tool index" << index;
+    qCDebug(lcUi) << "tool index" << index;
     switch (index) {
     case 0:
         ui->angleSpinBox->setEnabled(true);
@@ -491,8 +594,8 @@ void MainWindow::on_toolBox_currentIndexChanged(int index){
     ui->mainView->toolRenderers[idx]->setTool(tool);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -507,7 +610,7 @@ void MainWindow::on_toolBox_currentIndexChanged(int index){
  * @param value new a coefficient.
  */
 void MainWindow::on_spinBox_a_x_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_a_x_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_a_x_valueChanged";
   int idx = ui->mainView->settings.selectedIdx;
   if (idx == -1) return;
 
@@ -515,8 +618,8 @@ void MainWindow::on_spinBox_a_x_valueChanged(int value) {
   env->getToolMovement().getPath().getX().setA(value);
 
   QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-  ui->mainView->toolMeshUpdates += depEnvs;
-  ui->mainView->envelopeMeshUpdates += depEnvs;
+  ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+  ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
   ui->mainView->toolTransfUpdates += depEnvs;
   ui->mainView->update();
 }
@@ -526,7 +629,7 @@ void MainWindow::on_spinBox_a_x_valueChanged(int value) {
  * @param value new b coefficient.
  */
 void MainWindow::on_spinBox_b_x_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_b_x_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_b_x_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -534,8 +637,8 @@ void MainWindow::on_spinBox_b_x_valueChanged(int value) {
     env->getToolMovement().getPath().getX().setB(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -545,7 +648,7 @@ void MainWindow::on_spinBox_b_x_valueChanged(int value) {
  * @param value new c coefficient.
  */
 void MainWindow::on_spinBox_c_x_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_c_x_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_c_x_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -553,8 +656,8 @@ void MainWindow::on_spinBox_c_x_valueChanged(int value) {
     env->getToolMovement().getPath().getX().setC(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -564,7 +667,7 @@ void MainWindow::on_spinBox_c_x_valueChanged(int value) {
  * @param value new c coefficient.
  */
 void MainWindow::on_spinBox_d_x_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_d_x_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_d_x_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -572,8 +675,8 @@ void MainWindow::on_spinBox_d_x_valueChanged(int value) {
     env->getToolMovement().getPath().getX().setD(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -583,7 +686,7 @@ void MainWindow::on_spinBox_d_x_valueChanged(int value) {
  * @param value new a coefficient.
  */
 void MainWindow::on_spinBox_a_y_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_a_y_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_a_y_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -591,8 +694,8 @@ void MainWindow::on_spinBox_a_y_valueChanged(int value) {
     env->getToolMovement().getPath().getY().setA(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -602,7 +705,7 @@ void MainWindow::on_spinBox_a_y_valueChanged(int value) {
  * @param value new b coefficient.
  */
 void MainWindow::on_spinBox_b_y_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_b_y_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_b_y_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -610,8 +713,8 @@ void MainWindow::on_spinBox_b_y_valueChanged(int value) {
     env->getToolMovement().getPath().getY().setB(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -621,7 +724,7 @@ void MainWindow::on_spinBox_b_y_valueChanged(int value) {
  * @param value new c coefficient.
  */
 void MainWindow::on_spinBox_c_y_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_c_y_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_c_y_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -629,8 +732,8 @@ void MainWindow::on_spinBox_c_y_valueChanged(int value) {
     env->getToolMovement().getPath().getY().setC(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -640,7 +743,7 @@ void MainWindow::on_spinBox_c_y_valueChanged(int value) {
  * @param value new c coefficient.
  */
 void MainWindow::on_spinBox_d_y_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_d_y_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_d_y_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -648,8 +751,8 @@ void MainWindow::on_spinBox_d_y_valueChanged(int value) {
     env->getToolMovement().getPath().getY().setD(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -660,7 +763,7 @@ void MainWindow::on_spinBox_d_y_valueChanged(int value) {
  * @param value new a coefficient.
  */
 void MainWindow::on_spinBox_a_z_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_a_z_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_a_z_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -668,8 +771,8 @@ void MainWindow::on_spinBox_a_z_valueChanged(int value) {
     env->getToolMovement().getPath().getZ().setA(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -679,7 +782,7 @@ void MainWindow::on_spinBox_a_z_valueChanged(int value) {
  * @param value new b coefficient.
  */
 void MainWindow::on_spinBox_b_z_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_b_z_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_b_z_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -687,8 +790,8 @@ void MainWindow::on_spinBox_b_z_valueChanged(int value) {
     env->getToolMovement().getPath().getZ().setB(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -698,7 +801,7 @@ void MainWindow::on_spinBox_b_z_valueChanged(int value) {
  * @param value new c coefficient.
  */
 void MainWindow::on_spinBox_c_z_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_c_z_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_c_z_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -706,8 +809,8 @@ void MainWindow::on_spinBox_c_z_valueChanged(int value) {
     env->getToolMovement().getPath().getZ().setC(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -717,7 +820,7 @@ void MainWindow::on_spinBox_c_z_valueChanged(int value) {
  * @param value new c coefficient.
  */
 void MainWindow::on_spinBox_d_z_valueChanged(int value) {
-    qDebug() << ":: on_spinBox_d_z_valueChanged";
+    qCDebug(lcUi) << ":: on_spinBox_d_z_valueChanged";
     int idx = ui->mainView->settings.selectedIdx;
     if (idx == -1) return;
 
@@ -725,8 +828,8 @@ void MainWindow::on_spinBox_d_z_valueChanged(int value) {
     env->getToolMovement().getPath().getZ().setD(value);
 
     QSet<int> depEnvs = ui->mainView->envelopes[idx]->getAllDependents();
-    ui->mainView->toolMeshUpdates += depEnvs;
-    ui->mainView->envelopeMeshUpdates += depEnvs;
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::ToolMesh);
+    ui->mainView->meshJobs.request(depEnvs, MeshJobQueue::EnvelopeMesh);
     ui->mainView->toolTransfUpdates += depEnvs;
     ui->mainView->update();
 }
@@ -742,7 +845,7 @@ void MainWindow::on_spinBox_d_z_valueChanged(int value) {
  * @param checked The new value of the checkbox.
  */
 void MainWindow::on_envelopeCheckBox_toggled(bool checked){
-    qDebug() << ":: on_envelopeCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_envelopeCheckBox_toggled";
   ui->mainView->settings.showEnvelope = checked;
   ui->mainView->update();
 }
@@ -752,7 +855,7 @@ void MainWindow::on_envelopeCheckBox_toggled(bool checked){
  * @param checked The new value of the checkbox.
  */
 void MainWindow::on_toolCheckBox_toggled(bool checked){
-    qDebug() << ":: on_toolCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_toolCheckBox_toggled";
   ui->mainView->settings.showTool = checked;
   ui->mainView->update();
 }
@@ -762,7 +865,7 @@ void MainWindow::on_toolCheckBox_toggled(bool checked){
  * @param checked The new value of the checkbox.
  */
 void MainWindow::on_grazCurveCheckBox_toggled(bool checked){
-    qDebug() << ":: on_grazCurveCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_grazCurveCheckBox_toggled";
   ui->mainView->settings.showGrazingCurve = checked;
   ui->mainView->update();
 }
@@ -772,7 +875,7 @@ void MainWindow::on_grazCurveCheckBox_toggled(bool checked){
  * @param checked The new value of the checkbox.
  */
 void MainWindow::on_pathCheckBox_toggled(bool checked){
-    qDebug() << ":: on_pathCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_pathCheckBox_toggled";
   ui->mainView->settings.showPath = checked;
   ui->mainView->update();
 }
@@ -782,7 +885,7 @@ void MainWindow::on_pathCheckBox_toggled(bool checked){
  * @param checked The new value of the checkbox.
  */
 void MainWindow::on_toolAxisCheckBox_toggled(bool checked){
-    qDebug() << ":: on_toolAxisCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_toolAxisCheckBox_toggled";
   ui->mainView->settings.showToolAxis = checked;
   ui->mainView->update();
 }
@@ -792,7 +895,7 @@ void MainWindow::on_toolAxisCheckBox_toggled(bool checked){
  * @param checked The new value of the checkbox.
  */
 void MainWindow::on_normalsCheckBox_toggled(bool checked){
-    qDebug() << ":: on_normalsCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_normalsCheckBox_toggled";
   ui->mainView->settings.showNormals = checked;
   ui->mainView->update();
 }
@@ -802,48 +905,71 @@ void MainWindow::on_normalsCheckBox_toggled(bool checked){
  * @param checked The new value of the checkbox.
  */
 void MainWindow::on_sphereCheckBox_toggled(bool checked){
-    qDebug() << ":: on_sphereCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_sphereCheckBox_toggled";
   ui->mainView->settings.showSpheres = checked;
   ui->mainView->update();
 }
 
+/**
+ * @brief MainWindow::on_timingsCheckBox_toggled Turns recording the timings on or off, together with the overlay showing them.
+ * @param checked The new value of the checkbox.
+ */
+void MainWindow::on_timingsCheckBox_toggled(bool checked){
+    qCDebug(lcUi) << ":: on_timingsCheckBox_toggled";
+  Profiler::instance()->setEnabled(checked);
+  ui->mainView->settings.showTimings = checked;
+  ui->mainView->update();
+}
+
+/**
+ * @brief MainWindow::on_saveTimingsButton_clicked Writes the statistics of all timings recorded so far to a CSV file.
+ */
+void MainWindow::on_saveTimingsButton_clicked(){
+    qCDebug(lcUi) << ":: on_saveTimingsButton_clicked";
+  QString fileName = QFileDialog::getSaveFileName(this, "Save Timings", QString(), "CSV files (*.csv)");
+  if (fileName.isEmpty()) return;
+  QString errorText;
+  if (!Profiler::instance()->saveCsv(fileName, errorText)) {
+    error.showMessage(QString("Cannot save the timings: %1").arg(errorText));
+  }
+}
+
+/**
+ * @brief MainWindow::on_threadsSpinBox_valueChanged Changes the number of threads of the task pool. The pool is resized by the main view
+ * once no meshes are being computed.
+ * @param value The new number of threads.
+ */
+void MainWindow::on_threadsSpinBox_valueChanged(int value){
+    qCDebug(lcUi) << ":: on_threadsSpinBox_valueChanged";
+    ui->mainView->settings.threadCount = value;
+    ui->mainView->update();
+}
+
 /**
  * @brief MainWindow::on_reflecLinesCheckBox_toggled Updates the envelope's shading.
  * @param checked The new value of the checkbox.
  */
 void MainWindow::on_reflecLinesCheckBox_toggled(bool checked){
-    qDebug() << ":: on_reflecLinesCheckBox_toggled";
+    qCDebug(lcUi) << ":: on_reflecLinesCheckBox_toggled";
     ui->fracReflSpinBox->setEnabled(checked);
     ui->freqReflSpinBox->setEnabled(checked);
 
     ui->mainView->settings.reflectionLines = checked;
-    for (int i = 0; i < ui->mainView->envelopes.size(); i++) {
-        if (!ui->mainView->indicesUsed[i]) continue;
-        ui->mainView->envelopes[i]->updateRenderSettings(ui->mainView->settings);
-        ui->mainView->envelopeMeshUpdates += i;
-    }
+    ui->mainView->updateAllUniforms = true;
     ui->mainView->update();
 }
 
 void MainWindow::on_freqReflSpinBox_valueChanged(int value){
-    qDebug() << ":: on_freqReflSpinBox_valueChanged";
+    qCDebug(lcUi) << ":: on_freqReflSpinBox_valueChanged";
     ui->mainView->settings.reflFreq = value;
-    for (int i = 0; i < ui->mainView->envelopes.size(); i++) {
-        if (!ui->mainView->indicesUsed[i]) continue;
-        ui->mainView->envelopes[i]->updateRenderSettings(ui->mainView->settings);
-        ui->mainView->envelopeMeshUpdates += i;
-    }
+    ui->mainView->updateAllUniforms = true;
     ui->mainView->update();
 }
 
 void MainWindow::on_fracReflSpinBox_valueChanged(double value){
-    qDebug() << ":: on_fracReflSpinBox_valueChanged";
+    qCDebug(lcUi) << ":: on_fracReflSpinBox_valueChanged";
     ui->mainView->settings.percentBlack = value;
-    for (int i = 0; i < ui->mainView->envelopes.size(); i++) {
-        if (!ui->mainView->indicesUsed[i]) continue;
-        ui->mainView->envelopes[i]->updateRenderSettings(ui->mainView->settings);
-        ui->mainView->envelopeMeshUpdates += i;
-    }
+    ui->mainView->updateAllUniforms = true;
     ui->mainView->update();
 }
 
@@ -852,24 +978,21 @@ void MainWindow::on_fracReflSpinBox_valueChanged(double value){
  * @param value The new number of sectors.
  */
 void MainWindow::on_axisSectorsSpinBox_valueChanged(int value) {
-    qDebug() << ":: on_axisSectorsSpinBox_valueChanged";
-    qDebug() << "TODO change to dynamic";
+    qCDebug(lcUi) << ":: on_axisSectorsSpinBox_valueChanged";
+    qCDebug(lcUi) << "TODO change to dynamic";
     ui->aSlider->setMaximum(value);
     ui->mainView->settings.aSectors = value;
 
     for (int i = 0; i < ui->mainView->envelopes.size(); i++) {
         if (!ui->mainView->indicesUsed[i]) continue;
         ui->mainView->envelopes[i]->setSectorsA(value);
-        ui->mainView->envelopes[i]->update();
+        ui->mainView->meshJobs.request(i, MeshJobQueue::EnvelopeMesh);
 
         ui->mainView->cylinders[i]->setSectors(value);
-        ui->mainView->cylinders[i]->update();
-
         ui->mainView->drums[i]->setSectors(value);
-        ui->mainView->drums[i]->update();
+        ui->mainView->meshJobs.request(i, MeshJobQueue::ToolMesh);
     }
 
-    ui->mainView->updateBuffers();
     ui->mainView->updateToolTransf();
     ui->mainView->update();
 }
@@ -879,23 +1002,39 @@ void MainWindow::on_axisSectorsSpinBox_valueChanged(int value) {
  * @param value The new number of sectors.
  */
 void MainWindow::on_timeSectorsSpinBox_valueChanged(int value) {
-    qDebug() << ":: on_timeSectorsSpinBox_valueChanged";
+    qCDebug(lcUi) << ":: on_timeSectorsSpinBox_valueChanged";
     ui->TimeSlider->setMaximum(value);
     ui->mainView->settings.tSectors = value;
 
     for (int i = 0; i < ui->mainView->envelopes.size(); i++) {
         if (!ui->mainView->indicesUsed[i]) continue;
         ui->mainView->envelopes[i]->setSectorsT(value);
-        ui->mainView->envelopes[i]->update();
+        ui->mainView->meshJobs.request(i, MeshJobQueue::EnvelopeMesh);
         SimplePath &path = ui->mainView->envelopes[i]->getToolMovement().getPath();
         path.setSectors(value);
     }
 
-    ui->mainView->updateBuffers();
     ui->mainView->updateToolTransf();
     ui->mainView->update();
 }
 
+/**
+ * @brief MainWindow::on_toleranceSpinBox_valueChanged Updates the tolerance of the adaptive envelope meshes.
+ * @param value Largest distance between an envelope and its mesh, 0 for the uniform grid.
+ */
+void MainWindow::on_toleranceSpinBox_valueChanged(double value) {
+    qCDebug(lcUi) << ":: on_toleranceSpinBox_valueChanged";
+    ui->mainView->settings.tessellationTolerance = value;
+
+    for (int i = 0; i < ui->mainView->envelopes.size(); i++) {
+        if (!ui->mainView->indicesUsed[i]) continue;
+        ui->mainView->envelopes[i]->setTolerance(value);
+        ui->mainView->meshJobs.request(i, MeshJobQueue::EnvelopeMesh);
+    }
+
+    ui->mainView->update();
+}
+
 
 
 /***********************************************************/
@@ -907,7 +1046,7 @@ void MainWindow::on_timeSectorsSpinBox_valueChanged(int value) {
  * @param value The new time value.
  */
 void MainWindow::on_TimeSlider_sliderMoved(int value) {
-    qDebug() << ":: on_TimeSlider_sliderMoved";
+    qCDebug(lcUi) << ":: on_TimeSlider_sliderMoved";
   CylinderMovement &move = ui->mainView->envelopes[0]->getToolMovement();
   SimplePath &path = move.getPath();
   ui->mainView->settings.timeIdx = value;
@@ -923,7 +1062,7 @@ void MainWindow::on_TimeSlider_sliderMoved(int value) {
  * @param value The new a value.
  */
 void MainWindow::on_aSlider_sliderMoved(int value) {
-    qDebug() << ":: on_aSlider_sliderMoved";
+    qCDebug(lcUi) << ":: on_aSlider_sliderMoved";
   ui->mainView->settings.aIdx = value;
   ui->mainView->updateBuffers();
   ui->mainView->update();
@@ -933,7 +1072,7 @@ void MainWindow::on_aSlider_sliderMoved(int value) {
  * @brief MainWindow::on_ResetRotationButton_clicked Resets the rotation.
  */
 void MainWindow::on_ResetRotationButton_clicked() {
-    qDebug() << ":: on_ResetRotationButton_clicked";
+    qCDebug(lcUi) << ":: on_ResetRotationButton_clicked";
   ui->RotationDialX->setValue(0);
   ui->RotationDialY->setValue(0);
   ui->RotationDialZ->setValue(0);
@@ -946,7 +1085,7 @@ void MainWindow::on_ResetRotationButton_clicked() {
  * @param value Unused.
  */
 void MainWindow::on_RotationDialX_sliderMoved(int value) {
-    qDebug() << ":: on_RotationDialX_sliderMoved";
+    qCDebug(lcUi) << ":: on_RotationDialX_sliderMoved";
   ui->mainView->setRotation(value, ui->RotationDialY->value(),
                             ui->RotationDialZ->value());
 }
@@ -957,7 +1096,7 @@ void MainWindow::on_RotationDialX_sliderMoved(int value) {
  * @param value Unused.
  */
 void MainWindow::on_RotationDialY_sliderMoved(int value) {
-    qDebug() << ":: on_RotationDialY_sliderMoved";
+    qCDebug(lcUi) << ":: on_RotationDialY_sliderMoved";
   ui->mainView->setRotation(ui->RotationDialX->value(), value,
                             ui->RotationDialZ->value());
 }
@@ -968,7 +1107,7 @@ void MainWindow::on_RotationDialY_sliderMoved(int value) {
  * @param value Unused.
  */
 void MainWindow::on_RotationDialZ_sliderMoved(int value) {
-    qDebug() << ":: on_RotationDialZ_sliderMoved";
+    qCDebug(lcUi) << ":: on_RotationDialZ_sliderMoved";
   ui->mainView->setRotation(ui->RotationDialX->value(),
                             ui->RotationDialY->value(), value);
 }
@@ -977,7 +1116,7 @@ void MainWindow::on_RotationDialZ_sliderMoved(int value) {
  * @brief MainWindow::on_ResetScaleButton_clicked Resets the scale factor.
  */
 void MainWindow::on_ResetScaleButton_clicked() {
-    qDebug() << ":: on_ResetScaleButton_clicked";
+    qCDebug(lcUi) << ":: on_ResetScaleButton_clicked";
   ui->ScaleSlider->setValue(100);
   ui->mainView->setScale(1);
 }
@@ -987,7 +1126,7 @@ void MainWindow::on_ResetScaleButton_clicked() {
  * @param value The new scale value.
  */
 void MainWindow::on_ScaleSlider_sliderMoved(int value) {
-    qDebug() << ":: on_ScaleSlider_sliderMoved";
+    qCDebug(lcUi) << ":: on_ScaleSlider_sliderMoved";
   ui->mainView->setScale(value / 100.0f);
 }
 
@@ -44,6 +44,9 @@ class MainWindow : public QMainWindow {
   void on_tanContCheckBox_toggled(bool checked);
 
   void on_newEnvelopeButton_clicked();
+  void on_loadSceneButton_clicked();
+  void on_saveSceneButton_clicked();
+  void on_exportMeshesButton_clicked();
 
   // Tool menu
   void on_orientVector_1_returnPressed();
@@ -79,11 +82,15 @@ class MainWindow : public QMainWindow {
   void on_toolAxisCheckBox_toggled(bool checked);
   void on_normalsCheckBox_toggled(bool checked);
   void on_sphereCheckBox_toggled(bool checked);
+  void on_timingsCheckBox_toggled(bool checked);
+  void on_saveTimingsButton_clicked();
+  void on_threadsSpinBox_valueChanged(int value);
   void on_reflecLinesCheckBox_toggled(bool checked);
   void on_freqReflSpinBox_valueChanged(int value);
   void on_fracReflSpinBox_valueChanged(double value);
   void on_axisSectorsSpinBox_valueChanged(int value);
   void on_timeSectorsSpinBox_valueChanged(int value);
+  void on_toleranceSpinBox_valueChanged(double value);
 
   // General Side menu
   void on_TimeSlider_sliderMoved(int value);
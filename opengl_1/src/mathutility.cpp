@@ -94,6 +94,47 @@ QVector3D MathUtility::normalVectorDerivative3(QVector3D a, QVector3D da, QVecto
     return dddb;
 }
 
+/**
+ * @brief normalVectorDerivatives Calculates a normalized vector and its derivatives up to the given order in one pass, sharing the intermediate terms.
+ * @param a The unnormalized vector and its derivatives, a[k] holds the k-th derivative
+ * @param b Output, b[k] holds the k-th derivative of the normalized vector
+ * @param order Highest derivative, at most 3
+ */
+void MathUtility::normalVectorDerivatives(const QVector3D *a, QVector3D *b, int order)
+{
+    // Unit vector b
+    b[0] = a[0].normalized();
+    if (order < 1) return;
+    float L = a[0].length();
+
+    // First derivative db
+    float dL = QVector3D::dotProduct(a[0], a[1]) / L;
+    QVector3D c = L * a[1] - a[0] * dL;
+    float L2 = L * L;
+    b[1] = c / L2;
+    if (order < 2) return;
+
+    // Second derivative ddb
+    float m = L * (QVector3D::dotProduct(a[1], a[1]) + QVector3D::dotProduct(a[0], a[2])) - QVector3D::dotProduct(a[0], a[1]) * dL;
+    float ddL = m / L2;
+    QVector3D dc = L * a[2] - a[0] * ddL;
+    float L4 = L2 * L2;
+    float dL2 = 2 * L * dL;
+    QVector3D f = L2 * dc - c * dL2;
+    b[2] = f / L4;
+    if (order < 3) return;
+
+    // Third derivative dddb
+    float dm = L * (QVector3D::dotProduct(a[0], a[3]) + 3 * QVector3D::dotProduct(a[1], a[2])) - QVector3D::dotProduct(a[0], a[1]) * ddL;
+    float dddL = (L2 * dm - m * dL2) / L4;
+    QVector3D ddc = (dL * a[2] + L * a[3]) - (a[1] * ddL + a[0] * dddL);
+    float ddL2 = 2 * (dL * dL + L * ddL);
+    QVector3D df = L2 * ddc - c * ddL2;
+    float L8 = L4 * L4;
+    float dL4 = 4 * (L * L * L) * dL;
+    b[3] = (L4 * df - f * dL4) / L8;
+}
+
 /**
  * @brief normalVectorDerivative4 Calculates the fourth derivative of a normalized vector.
  * @param a The unnormalized vector
@@ -139,11 +180,11 @@ QVector3D MathUtility::normalVectorDerivative4(QVector3D a, QVector3D da, QVecto
     // Fourth derivative ddddb
     float ddm = (dL * (QVector3D::dotProduct(a, ddda) + 3 * QVector3D::dotProduct(da, dda)) + L * (QVector3D::dotProduct(a, dddda) + 3 * QVector3D::dotProduct(dda, dda) + 4 * QVector3D::dotProduct(da, ddda))) - ((QVector3D::dotProduct(da, da) + QVector3D::dotProduct(a, dda)) * ddL + QVector3D::dotProduct(a, da) * dddL);
     float dn = L2 * ddm - m * ddL2;
-    float ddddL = L4 * dn - n * dL4 / L8;
+    float ddddL = (L4 * dn - n * dL4) / L8;
     QVector3D dddc = (ddL * dda + dL * ddda + dL * ddda + L * dddda) - (dda * ddL + da * dddL + da * dddL + a * ddddL);
     float dddL2 = 2 * (2 * dL * ddL + dL * ddL + L * dddL);
     QVector3D ddf = (dL2 * ddc + L2 * dddc) - (dc * ddL2 + c * dddL2);
-    float ddL4 = 4 * (3 * pow(L, 2) * dL + pow(L, 3) * ddL);
+    float ddL4 = 4 * (3 * pow(L, 2) * dL * dL + pow(L, 3) * ddL);
     QVector3D dg = L4 * ddf - f * ddL4;
     float L16 = L8 * L8;
     float dL8 = 8 * pow(L, 7) * dL;
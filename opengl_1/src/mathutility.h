@@ -12,6 +12,7 @@ public:
     static QVector3D normalVectorDerivative2(QVector3D a, QVector3D da, QVector3D dda);
     static QVector3D normalVectorDerivative3(QVector3D a, QVector3D da, QVector3D dda, QVector3D ddda);
     static QVector3D normalVectorDerivative4(QVector3D a, QVector3D da, QVector3D dda, QVector3D ddda, QVector3D dddda);
+    static void normalVectorDerivatives(const QVector3D *a, QVector3D *b, int order);
 };
 
 #endif // MATHUTILITY_H
@@ -0,0 +1,238 @@
+#include "meshexporter.h"
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief The ChunkWriter class collects little endian binary data in a fixed size buffer and writes it to the device whenever the buffer is full.
+ */
+class ChunkWriter
+{
+    static const qsizetype Capacity = 1 << 16;
+
+    QIODevice &device;
+    QByteArray buffer;
+    bool failed = false;
+
+public:
+    ChunkWriter(QIODevice &device) : device(device) { buffer.reserve(Capacity); }
+
+    template<typename T> inline void put(T value) {
+        T littleEndian = qToLittleEndian(value);
+        append(&littleEndian, sizeof(T));
+    }
+    inline void put(float value) {
+        quint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        put(bits);
+    }
+    inline void put(const QVector3D &v) {
+        put(v.x());
+        put(v.y());
+        put(v.z());
+    }
+    inline void putText(const QByteArray &text) { append(text.constData(), text.size()); }
+
+    inline void append(const void *data, qsizetype size) {
+        if (buffer.size() + size > Capacity) flush();
+        buffer.append(static_cast<const char*>(data), size);
+    }
+
+    bool flush() {
+        if (!buffer.isEmpty() && device.write(buffer) != buffer.size()) failed = true;
+        buffer.clear();
+        return !failed;
+    }
+};
+
+QByteArray plyHeader(const QString &comment, qsizetype numVertices, bool normals, bool parameters, qsizetype numFaces)
+{
+    QByteArray header = "ply\nformat binary_little_endian 1.0\n";
+    header += "comment " + comment.toUtf8() + "\n";
+    header += "element vertex " + QByteArray::number(numVertices) + "\n";
+    header += "property float x\nproperty float y\nproperty float z\n";
+    if (normals) header += "property float nx\nproperty float ny\nproperty float nz\n";
+    if (parameters) header += "property float t\nproperty float a\n";
+    header += "element face " + QByteArray::number(numFaces) + "\n";
+    header += "property list uchar uint vertex_indices\nend_header\n";
+    return header;
+}
+
+void stlTriangle(ChunkWriter &out, const QVector3D &normal, const QVector3D &p1, const QVector3D &p2, const QVector3D &p3)
+{
+    out.put(normal);
+    out.put(p1);
+    out.put(p2);
+    out.put(p3);
+    out.put((quint16) 0);
+}
+
+void stlHeader(ChunkWriter &out, const QString &comment, quint32 numTriangles)
+{
+    QByteArray header = comment.toUtf8().left(80);
+    header.append(80 - header.size(), ' ');
+    out.putText(header);
+    out.put(numTriangles);
+}
+
+/**
+ * @brief openFile Opens the file for writing and determines its format. Sets error on failure.
+ */
+bool openFile(QSaveFile &file, MeshExporter::Format &format, QString &error)
+{
+    if (!MeshExporter::formatOf(file.fileName(), format)) {
+        error = QString("%1 is neither a .ply nor an .stl file").arg(file.fileName());
+        return false;
+    }
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief closeFile Writes the rest of the buffer and replaces the file by the written one. Sets error on failure.
+ */
+bool closeFile(QSaveFile &file, ChunkWriter &out, QString &error)
+{
+    if (!out.flush()) {
+        file.cancelWriting();
+        error = file.errorString();
+        return false;
+    }
+    if (!file.commit()) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+}
+
+/**
+ * @brief MeshExporter::formatOf Determines the format of a mesh file from its suffix, .ply or .stl.
+ * @return False if the suffix is neither.
+ */
+bool MeshExporter::formatOf(const QString &fileName, Format &format)
+{
+    if (fileName.endsWith(".ply", Qt::CaseInsensitive)) {
+        format = PLY;
+        return true;
+    }
+    if (fileName.endsWith(".stl", Qt::CaseInsensitive)) {
+        format = STL;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief MeshExporter::exportEnvelope Writes the current mesh of an envelope.
+ * @param parameters Whether the (t,a) parameters of the vertices are written as well. Only PLY files can hold them.
+ * @param error Set to a description of the problem if the file cannot be written.
+ * @return False if the file cannot be written, in which case an existing file is left as it was.
+ */
+bool MeshExporter::exportEnvelope(const Envelope &env, const QString &fileName, QString &error, bool parameters)
+{
+    QSaveFile file(fileName);
+    Format format;
+    if (!openFile(file, format, error)) return false;
+    ChunkWriter out(file);
+
+    const QVector<EnvelopeVertex> &vertices = env.getVertexArr();
+    const QVector<unsigned int> &indices = env.getIndexArr();
+    qsizetype numTriangles = indices.size() / 3;
+    QString comment = QString("envelope %1").arg(env.getIndex());
+
+    if (format == PLY) {
+        out.putText(plyHeader(comment, vertices.size(), true, parameters, numTriangles));
+        for (int i = 0; i < vertices.size(); i++) {
+            const EnvelopeVertex &v = vertices[i];
+            QVector3D n = v.getNormal();
+            out.put(v.xCoord);
+            out.put(v.yCoord);
+            out.put(v.zCoord);
+            out.put(n.x());
+            out.put(n.y());
+            out.put(n.z());
+            if (parameters) {
+                QVector2D ta = env.getVertexParamsAt(i);
+                out.put(ta.x());
+                out.put(ta.y());
+            }
+        }
+        for (qsizetype i = 0; i < numTriangles; i++) {
+            out.put((quint8) 3);
+            out.put((quint32) indices[3 * i]);
+            out.put((quint32) indices[3 * i + 1]);
+            out.put((quint32) indices[3 * i + 2]);
+        }
+    } else {
+        stlHeader(out, comment, numTriangles);
+        for (qsizetype i = 0; i < numTriangles; i++) {
+            const EnvelopeVertex &v1 = vertices[indices[3 * i]];
+            const EnvelopeVertex &v2 = vertices[indices[3 * i + 1]];
+            const EnvelopeVertex &v3 = vertices[indices[3 * i + 2]];
+            QVector3D p1 = v1.getPosition();
+            QVector3D p2 = v2.getPosition();
+            QVector3D p3 = v3.getPosition();
+            QVector3D normal = QVector3D::crossProduct(p2 - p1, p3 - p1).normalized();
+            QVector3D surfaceNormal = v1.getNormal() + v2.getNormal() + v3.getNormal();
+            // STL orders the corners counter clockwise around the facet normal
+            if (QVector3D::dotProduct(normal, surfaceNormal) < 0) {
+                stlTriangle(out, -normal, p1, p3, p2);
+            } else {
+                stlTriangle(out, normal, p1, p2, p3);
+            }
+        }
+    }
+    return closeFile(file, out, error);
+}
+
+/**
+ * @brief MeshExporter::exportTool Writes the mesh of a tool.
+ * @param transform Transformation of the tool, for example its placement at some time along its path.
+ * @param error Set to a description of the problem if the file cannot be written.
+ * @return False if the file cannot be written, in which case an existing file is left as it was.
+ */
+bool MeshExporter::exportTool(const Tool &tool, const QMatrix4x4 &transform, const QString &fileName, QString &error)
+{
+    QSaveFile file(fileName);
+    Format format;
+    if (!openFile(file, format, error)) return false;
+    ChunkWriter out(file);
+
+    // Tool meshes are lists of triangles, with three vertices of their own each
+    const QVector<Vertex> &vertices = tool.getVertexArr();
+    qsizetype numTriangles = vertices.size() / 3;
+    QString comment = "tool";
+    auto position = [&](qsizetype i) {
+        const Vertex &v = vertices[i];
+        return transform.map(QVector3D(v.xCoord, v.yCoord, v.zCoord));
+    };
+
+    if (format == PLY) {
+        out.putText(plyHeader(comment, 3 * numTriangles, false, false, numTriangles));
+        for (qsizetype i = 0; i < 3 * numTriangles; i++) {
+            out.put(position(i));
+        }
+        for (qsizetype i = 0; i < numTriangles; i++) {
+            out.put((quint8) 3);
+            out.put((quint32) (3 * i));
+            out.put((quint32) (3 * i + 1));
+            out.put((quint32) (3 * i + 2));
+        }
+    } else {
+        stlHeader(out, comment, numTriangles);
+        for (qsizetype i = 0; i < numTriangles; i++) {
+            QVector3D p1 = position(3 * i);
+            QVector3D p2 = position(3 * i + 1);
+            QVector3D p3 = position(3 * i + 2);
+            stlTriangle(out, QVector3D::crossProduct(p2 - p1, p3 - p1).normalized(), p1, p2, p3);
+        }
+    }
+    return closeFile(file, out, error);
+}
@@ -0,0 +1,28 @@
+#ifndef MESHEXPORTER_H
+#define MESHEXPORTER_H
+
+#include <QMatrix4x4>
+#include <QString>
+#include "envelope.h"
+#include "tools/tool.h"
+
+/**
+ * @brief The MeshExporter class writes envelope and tool meshes to binary PLY or STL files, chosen by the file suffix.
+ * Meshes are streamed from their vertex and index arrays through a small fixed size buffer, so exporting does not copy the mesh.
+ * PLY files hold every vertex once, with its normal and optionally its (t,a) parameters. STL files hold every triangle with its own
+ * corners and a facet normal, which for envelopes points the same way as the normals of the surface.
+ */
+class MeshExporter
+{
+public:
+    enum Format {
+        PLY,
+        STL
+    };
+
+    static bool formatOf(const QString &fileName, Format &format);
+    static bool exportEnvelope(const Envelope &env, const QString &fileName, QString &error, bool parameters = false);
+    static bool exportTool(const Tool &tool, const QMatrix4x4 &transform, const QString &fileName, QString &error);
+};
+
+#endif // MESHEXPORTER_H
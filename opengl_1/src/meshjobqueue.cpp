@@ -0,0 +1,105 @@
+#include "meshjobqueue.h"
+#include <limits>
+
+/**
+ * @brief MeshJobQueue::request Requests the mesh of the given kind of one envelope to be recomputed.
+ * @param index Index of the envelope.
+ * @param change Kind of mesh.
+ */
+void MeshJobQueue::request(int index, Change change)
+{
+    numRequested++;
+    sinceRequest.start();
+    if (pending[change].contains(index)) {
+        numCoalesced++;
+    } else {
+        pending[change].insert(index);
+    }
+    if (running[change].contains(index)) stale = true;
+}
+
+/**
+ * @brief MeshJobQueue::request Requests the meshes of the given kind of several envelopes to be recomputed.
+ */
+void MeshJobQueue::request(const QSet<int> &indices, Change change)
+{
+    for (int index : indices) {
+        request(index, change);
+    }
+}
+
+/**
+ * @brief MeshJobQueue::requestRefinement Requests envelope meshes to be recomputed at a finer resolution. Does not count as an edit.
+ */
+void MeshJobQueue::requestRefinement(const QSet<int> &indices)
+{
+    pending[EnvelopeMesh] += indices;
+    for (int index : indices) {
+        if (running[EnvelopeMesh].contains(index)) stale = true;
+    }
+}
+
+/**
+ * @brief MeshJobQueue::getMsecsSinceRequest Gives the time since the last request, which is how long the input has been idle.
+ */
+qint64 MeshJobQueue::getMsecsSinceRequest() const
+{
+    return sinceRequest.isValid() ? sinceRequest.elapsed() : std::numeric_limits<qint64>::max();
+}
+
+/**
+ * @brief MeshJobQueue::hasPending Checks whether any mesh waits to be recomputed.
+ */
+bool MeshJobQueue::hasPending() const
+{
+    for (int change = 0; change < NumChanges; change++) {
+        if (!pending[change].isEmpty()) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief MeshJobQueue::start Turns all pending requests into the running job.
+ */
+void MeshJobQueue::start()
+{
+    for (int change = 0; change < NumChanges; change++) {
+        running[change] = pending[change];
+        pending[change].clear();
+    }
+    hasRunning = true;
+    stale = false;
+}
+
+/**
+ * @brief MeshJobQueue::finish Ends the running job. The requests of a cancelled job are pending again.
+ * @param completed Whether the job was completed, false if it was cancelled.
+ */
+void MeshJobQueue::finish(bool completed)
+{
+    if (!hasRunning) return;
+    for (int change = 0; change < NumChanges; change++) {
+        if (!completed) pending[change] += running[change];
+        running[change].clear();
+    }
+    if (completed) {
+        numCompleted++;
+    } else {
+        numCancelled++;
+    }
+    hasRunning = false;
+    stale = false;
+}
+
+/**
+ * @brief MeshJobQueue::reset Drops all pending requests, and marks the running job as stale without requeueing its requests.
+ * Used when all envelopes are replaced, so that no mesh of the previous ones is computed or adopted.
+ */
+void MeshJobQueue::reset()
+{
+    for (int change = 0; change < NumChanges; change++) {
+        pending[change].clear();
+        running[change].clear();
+    }
+    if (hasRunning) stale = true;
+}
@@ -0,0 +1,56 @@
+#ifndef MESHJOBQUEUE_H
+#define MESHJOBQUEUE_H
+
+#include <QElapsedTimer>
+#include <QSet>
+
+/**
+ * @brief The MeshJobQueue class collects requests to recompute meshes, keyed by envelope index and kind of mesh.
+ * Requests for a mesh that is already pending are coalesced into one. Pending requests are started as one job,
+ * and a request for a mesh of the running job marks that job as stale, so it can be cancelled and requeued.
+ * Refinements of meshes that were computed at a coarse resolution are queued the same way, but are not counted as requests.
+ */
+class MeshJobQueue
+{
+public:
+    enum Change {
+        EnvelopeMesh,
+        ToolMesh,
+        NumChanges
+    };
+
+private:
+    QSet<int> pending[NumChanges];
+    QSet<int> running[NumChanges];
+    bool hasRunning = false;
+    bool stale = false;
+    QElapsedTimer sinceRequest;
+
+    // Statistics since the queue was created
+    int numRequested = 0;
+    int numCoalesced = 0;
+    int numCancelled = 0;
+    int numCompleted = 0;
+
+public:
+    void request(int index, Change change);
+    void request(const QSet<int> &indices, Change change);
+    void requestRefinement(const QSet<int> &indices);
+    qint64 getMsecsSinceRequest() const;
+
+    bool hasPending() const;
+    inline const QSet<int> &getPending(Change change) const { return pending[change]; }
+    inline bool isRunning() const { return hasRunning; }
+    inline bool isStale() const { return stale; }
+
+    void start();
+    void finish(bool completed);
+    void reset();
+
+    inline int getNumRequested() const { return numRequested; }
+    inline int getNumCoalesced() const { return numCoalesced; }
+    inline int getNumCancelled() const { return numCancelled; }
+    inline int getNumCompleted() const { return numCompleted; }
+};
+
+#endif // MESHJOBQUEUE_H
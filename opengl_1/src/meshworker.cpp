@@ -0,0 +1,146 @@
+#include "meshworker.h"
+#include "profiler.h"
+
+/**
+ * @brief MeshWorker::MeshWorker Creates the worker and starts its background thread.
+ */
+MeshWorker::MeshWorker(QObject *parent) : QObject(parent)
+{
+    context.moveToThread(&thread);
+    scheduler.setCancelFlag(&cancelled);
+    thread.start();
+}
+
+/**
+ * @brief MeshWorker::~MeshWorker Waits for the running job, if any, and stops the background thread.
+ */
+MeshWorker::~MeshWorker()
+{
+    thread.quit();
+    thread.wait();
+    for (Envelope *env : envelopes) delete env;
+    for (Cylinder *cyl : cylinders) delete cyl;
+    for (Drum *drum : drums) delete drum;
+}
+
+/**
+ * @brief MeshWorker::submit Starts a job that recomputes the given envelopes and tools, unless a job is still running.
+ * The definitions of all shown envelopes and tools are copied, as the given ones may depend on the others.
+ * @param shownEnvelopes Shown envelopes, nullptr for unused indices.
+ * @param envelopeIndices Indices of the envelopes to recompute.
+ * @param toolIndices Indices of the cylinders and drums to recompute.
+ * @param parallel Whether independent envelopes are computed concurrently.
+ * @param pipelined Whether dependent envelopes are computed row by row.
+ * @param coarsening Factor the sectors of the recomputed envelopes are divided by, 1 for their full resolution.
+ * @return False if a job is still running.
+ */
+bool MeshWorker::submit(const QVector<Envelope*> &shownEnvelopes, const QVector<Cylinder*> &shownCylinders, const QVector<Drum*> &shownDrums,
+                        const QSet<int> &envelopeIndices, const QSet<int> &toolIndices, bool parallel, bool pipelined, int coarsening)
+{
+    if (busy) return false;
+    resize(shownEnvelopes.size());
+
+    for (int i = 0; i < shownEnvelopes.size(); i++) {
+        if (shownCylinders[i] != nullptr) *cylinders[i] = *shownCylinders[i];
+        if (shownDrums[i] != nullptr) *drums[i] = *shownDrums[i];
+    }
+    for (int i = 0; i < shownEnvelopes.size(); i++) {
+        const Envelope *shown = shownEnvelopes[i];
+        if (shown == nullptr) continue;
+        Tool *tool = (shown->getTool() == shownDrums[i]) ? (Tool*) drums[i] : (Tool*) cylinders[i];
+        envelopes[i]->copyDefinition(*shown, tool, envelopes);
+    }
+    // The chordal error of a cell grows with the square of its size, so the tolerance of adaptive meshes is coarsened likewise
+    this->coarsening = std::max(coarsening, 1);
+    if (this->coarsening > 1) {
+        for (int i : envelopeIndices) {
+            Envelope *env = envelopes[i];
+            env->setSectorsA(std::max(env->getSectorsA() / this->coarsening, 1));
+            env->setSectorsT(std::max(env->getSectorsT() / this->coarsening, 1));
+            env->setTolerance(env->getTolerance() * this->coarsening * this->coarsening, env->getAngleTolerance());
+        }
+    }
+
+    envelopeJob = envelopeIndices;
+    toolJob = toolIndices;
+    scheduler.setParallel(parallel);
+    scheduler.setPipelined(pipelined);
+    busy = true;
+    done = false;
+    cancelled = false;
+    QMetaObject::invokeMethod(&context, [this] { run(); }, Qt::QueuedConnection);
+    return true;
+}
+
+/**
+ * @brief MeshWorker::collect Hands the meshes of the finished job to the shown envelopes and tools, unless the job was cancelled.
+ * @param envelopeIndices Filled with the indices of the envelopes that have new meshes.
+ * @param toolIndices Filled with the indices of the tools that have new meshes.
+ * @return False if the job was cancelled or is not done yet.
+ */
+bool MeshWorker::collect(const QVector<Envelope*> &shownEnvelopes, const QVector<Cylinder*> &shownCylinders, const QVector<Drum*> &shownDrums,
+                         QSet<int> &envelopeIndices, QSet<int> &toolIndices)
+{
+    envelopeIndices.clear();
+    toolIndices.clear();
+    if (!isDone()) return false;
+
+    bool completed = !cancelled;
+    if (!completed) {
+        envelopeJob.clear();
+        toolJob.clear();
+    }
+    for (int i : envelopeJob) {
+        if (shownEnvelopes[i] == nullptr) continue;
+        shownEnvelopes[i]->adoptMeshes(*envelopes[i]);
+        envelopeIndices.insert(i);
+    }
+    for (int i : toolJob) {
+        if (shownCylinders[i] == nullptr || shownDrums[i] == nullptr) continue;
+        shownCylinders[i]->getVertexArr().swap(cylinders[i]->getVertexArr());
+        shownDrums[i]->getVertexArr().swap(drums[i]->getVertexArr());
+        toolIndices.insert(i);
+    }
+    envelopeJob.clear();
+    toolJob.clear();
+    busy = false;
+    done = false;
+    return completed;
+}
+
+/**
+ * @brief MeshWorker::resize Makes sure there is a copy for every index.
+ */
+void MeshWorker::resize(int size)
+{
+    for (int i = envelopes.size(); i < size; i++) {
+        envelopes.append(new Envelope(i));
+        cylinders.append(new Cylinder());
+        drums.append(new Drum());
+    }
+}
+
+/**
+ * @brief MeshWorker::run Computes the job on the background thread.
+ */
+void MeshWorker::run()
+{
+    {
+        ProfileScope scope("meshworker/envelopes");
+        QVector<Envelope*> dirty;
+        for (int i : envelopeJob) dirty.append(envelopes[i]);
+        scheduler.update(dirty);
+    }
+
+    {
+        ProfileScope scope("meshworker/tools");
+        for (int i : toolJob) {
+            if (cancelled) break;
+            cylinders[i]->update();
+            drums[i]->update();
+        }
+    }
+
+    done.store(true, std::memory_order_release);
+    emit finished();
+}
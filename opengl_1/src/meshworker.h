@@ -0,0 +1,64 @@
+#ifndef MESHWORKER_H
+#define MESHWORKER_H
+
+#include <QObject>
+#include <QSet>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include "envelope.h"
+#include "envelopescheduler.h"
+#include "tools/cylinder.h"
+#include "tools/drum.h"
+
+/**
+ * @brief The MeshWorker class computes the meshes of envelopes and tools on a background thread.
+ * The worker keeps its own copies of all envelopes and tools. A job copies the definitions of the shown objects
+ * into them and computes the copies, so the shown objects can be edited and drawn meanwhile. Once the job is done,
+ * the shown objects adopt the finished meshes and keep drawing their previous meshes until then.
+ * A running job can be cancelled when its definitions are outdated, in which case nothing is adopted.
+ * Jobs may compute envelopes at a coarser resolution than their sectors, for quick previews.
+ * Apart from the background thread, all functions must be called from the thread the worker was created on.
+ */
+class MeshWorker : public QObject
+{
+    Q_OBJECT
+
+    QThread thread;
+    QObject context; // Lives on the background thread, so jobs can be queued to it
+
+    QVector<Envelope*> envelopes;
+    QVector<Cylinder*> cylinders;
+    QVector<Drum*> drums;
+    EnvelopeScheduler scheduler;
+
+    QSet<int> envelopeJob;
+    QSet<int> toolJob;
+    int coarsening = 1;
+    bool busy = false;
+    std::atomic<bool> done{false};
+    std::atomic<bool> cancelled{false};
+
+public:
+    MeshWorker(QObject *parent = nullptr);
+    ~MeshWorker() override;
+
+    inline bool isBusy() const { return busy; }
+    inline bool isDone() const { return done.load(std::memory_order_acquire); }
+    inline void cancel() { cancelled = true; }
+    inline int getCoarsening() const { return coarsening; }
+
+    bool submit(const QVector<Envelope*> &shownEnvelopes, const QVector<Cylinder*> &shownCylinders, const QVector<Drum*> &shownDrums,
+                const QSet<int> &envelopeIndices, const QSet<int> &toolIndices, bool parallel, bool pipelined, int coarsening = 1);
+    bool collect(const QVector<Envelope*> &shownEnvelopes, const QVector<Cylinder*> &shownCylinders, const QVector<Drum*> &shownDrums,
+                 QSet<int> &envelopeIndices, QSet<int> &toolIndices);
+
+signals:
+    void finished();
+
+private:
+    void resize(int size);
+    void run();
+};
+
+#endif // MESHWORKER_H
@@ -56,7 +56,7 @@ bool CylinderMovement::setAxisDirections(QVector3D axisDirection1, QVector3D axi
  * @param time time of interest
  * @return axis direction
  */
-QVector3D CylinderMovement::getAxisAt(float time)
+QVector3D CylinderMovement::getAxisAt(float time) const
 {
     QVector3D axis = axisT0 + (axisT1 - axisT0)*time;
     axis.normalize();
@@ -68,7 +68,7 @@ QVector3D CylinderMovement::getAxisAt(float time)
  * @param time time of interest
  * @return axis direction
  */
-QVector3D CylinderMovement::getAxisDtAt(float time)
+QVector3D CylinderMovement::getAxisDtAt(float time) const
 {
     QVector3D axis = axisT0 + (axisT1 - axisT0)*time;
     QVector3D axis_t = axisT1 - axisT0;
@@ -80,7 +80,7 @@ QVector3D CylinderMovement::getAxisDtAt(float time)
  * @param time time of interest
  * @return axis direction
  */
-QVector3D CylinderMovement::getAxisDt2At(float time)
+QVector3D CylinderMovement::getAxisDt2At(float time) const
 {
     QVector3D axis = axisT0 + (axisT1 - axisT0)*time;
     QVector3D axis_t = axisT1 - axisT0;
@@ -93,7 +93,7 @@ QVector3D CylinderMovement::getAxisDt2At(float time)
  * @param time time of interest
  * @return axis direction
  */
-QVector3D CylinderMovement::getAxisDt3At(float time)
+QVector3D CylinderMovement::getAxisDt3At(float time) const
 {
     QVector3D axis = axisT0 + (axisT1 - axisT0)*time;
     QVector3D axis_t = axisT1 - axisT0;
@@ -107,7 +107,7 @@ QVector3D CylinderMovement::getAxisDt3At(float time)
  * @param time time of interest
  * @return axis direction
  */
-QVector3D CylinderMovement::getAxisDt4At(float time)
+QVector3D CylinderMovement::getAxisDt4At(float time) const
 {
     QVector3D axis = axisT0 + (axisT1 - axisT0)*time;
     QVector3D axis_t = axisT1 - axisT0;
@@ -122,7 +122,7 @@ QVector3D CylinderMovement::getAxisDt4At(float time)
  * @param time time of interest
  * @return rotation vector
  */
-QVector3D CylinderMovement::getRotationVectorAt(float time)
+QVector3D CylinderMovement::getRotationVectorAt(float time) const
 {
     return QVector3D::crossProduct(toolAxis, getAxisAt(time));
 }
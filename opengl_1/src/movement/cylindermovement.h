@@ -6,7 +6,6 @@
 #include "../tools/drum.h"
 #include <QVector>
 #include <QVector3D>
-#include <QOpenGLDebugLogger>
 #include <QMatrix4x4>
 
 class CylinderMovement
@@ -25,19 +24,30 @@ public:
     CylinderMovement(SimplePath path, QVector3D axisDirection1, QVector3D axisDirection2, const Tool *tool);
 
     inline SimplePath& getPath() {return path;}
+    inline const SimplePath& getPath() const {return path;}
     bool setAxisDirections(QVector3D axisDirection1, QVector3D axisDirection2);
     inline QVector<Vertex>& getPathVertexArr() { return path.getVertexArr(); }
 
     inline QVector3D getAxisT0() const { return axisT0; }
     inline QVector3D getAxisT1() const { return axisT1; }
 
-    QVector3D getAxisAt(float time);
-    QVector3D getAxisDtAt(float time);
-    QVector3D getAxisDt2At(float time);
-    QVector3D getAxisDt3At(float time);
-    QVector3D getAxisDt4At(float time);
-
-    QVector3D getRotationVectorAt(float time);
+    QVector3D getAxisAt(float time) const;
+    QVector3D getAxisDtAt(float time) const;
+    QVector3D getAxisDt2At(float time) const;
+    QVector3D getAxisDt3At(float time) const;
+    QVector3D getAxisDt4At(float time) const;
+
+    /**
+     * @brief getAxisTaylorAt Returns the axis direction and its derivatives up to order N at time time as a Taylor series.
+     */
+    template<int N>
+    inline TaylorVector3D<N> getAxisTaylorAt(float time) const {
+        TaylorVector3D<N> axis(axisT0 + (axisT1 - axisT0)*time);
+        if constexpr (N >= 1) axis.c[1] = axisT1 - axisT0;
+        return axis.normalized();
+    }
+
+    QVector3D getRotationVectorAt(float time) const;
 };
 
 #endif // CYLINDERMOVEMENT_H
@@ -14,7 +14,7 @@ protected:
     int sectors = 50;
 public:
     inline Path() : vertexArr(), sectors(50) {}
-    virtual QVector3D getPathAt(float t) = 0;
+    virtual QVector3D getPathAt(float t) const = 0;
     virtual void updateVertexArr() = 0;
 
     inline void setSectors(int s) {sectors = s; updateVertexArr();}
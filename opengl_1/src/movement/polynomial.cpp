@@ -39,7 +39,7 @@ void Polynomial::setParameters(float a, float b, float c, float d)
  * @param t The time.
  * @return The value of the polynomial at time t.
 */
-float Polynomial::getValAt(float t)
+float Polynomial::getValAt(float t) const
 {
     return a*t*t*t + b*t*t + c*t + d;
 }
@@ -49,19 +49,19 @@ float Polynomial::getValAt(float t)
  * @param t The time.
  * @return The value of the derivative of the polynomial at time t.
 */
-float Polynomial::getDerivativeAt(float t)
+float Polynomial::getDerivativeAt(float t) const
 {
     return 3*a*t*t + 2*b*t + c;
 }
 
-float Polynomial::getDerivative2At(float t) {
+float Polynomial::getDerivative2At(float t) const {
     return 6*a*t + 2*b;
 }
 
-float Polynomial::getDerivative3At(float t) {
+float Polynomial::getDerivative3At(float t) const {
     return 6*a;
 }
 
-float Polynomial::getDerivative4PlusAt(float t) {
+float Polynomial::getDerivative4PlusAt(float t) const {
     return 0;
 }
@@ -1,6 +1,7 @@
 #ifndef POLYNOMIAL_H
 #define POLYNOMIAL_H
 
+#include "../taylor.h"
 
 /**
  * @brief The Polynomial class assumes an univariate polynomial
@@ -15,12 +16,18 @@ public:
     Polynomial();
     Polynomial(float a, float b, float c, float d);
 
-    float getValAt(float t);
+    float getValAt(float t) const;
     void setParameters(float a, float b, float c, float d);
-    float getDerivativeAt(float t);
-    float getDerivative2At(float t);
-    float getDerivative3At(float t);
-    float getDerivative4PlusAt(float t);
+    float getDerivativeAt(float t) const;
+    float getDerivative2At(float t) const;
+    float getDerivative3At(float t) const;
+    float getDerivative4PlusAt(float t) const;
+
+    /**
+     * @brief evaluate Evaluates the polynomial on any type with arithmetic, such as a Taylor series of t.
+     */
+    template<typename T>
+    inline T evaluate(const T &t) const { return ((a * t + b) * t + c) * t + d; }
 
     inline const float getA() const {return a;}
     inline const float getB() const {return b;}
@@ -22,7 +22,7 @@ SimplePath::SimplePath(Polynomial x, Polynomial y, Polynomial z)
  * @param t Time.
  * @return Path at time t.
 */
-QVector3D SimplePath::getPathAt(float t)
+QVector3D SimplePath::getPathAt(float t) const
 {
     QVector3D pt = QVector3D();
     pt.setX(x.getValAt(t));
@@ -50,7 +50,7 @@ void SimplePath::updateVertexArr()
  * @param t Time.
  * @return Tangent at time t.
 */
-QVector3D SimplePath::getDerivativeAt(float t)
+QVector3D SimplePath::getDerivativeAt(float t) const
 {
     QVector3D tangent = QVector3D();
     tangent.setX(x.getDerivativeAt(t));
@@ -59,7 +59,7 @@ QVector3D SimplePath::getDerivativeAt(float t)
     return tangent;
 }
 
-QVector3D SimplePath::getDerivative2At(float t) {
+QVector3D SimplePath::getDerivative2At(float t) const {
     QVector3D acc = QVector3D();
     acc.setX(x.getDerivative2At(t));
     acc.setY(y.getDerivative2At(t));
@@ -67,7 +67,7 @@ QVector3D SimplePath::getDerivative2At(float t) {
     return acc;
 }
 
-QVector3D SimplePath::getDerivative3At(float t) {
+QVector3D SimplePath::getDerivative3At(float t) const {
     QVector3D acc = QVector3D();
     acc.setX(x.getDerivative3At(t));
     acc.setY(y.getDerivative3At(t));
@@ -76,7 +76,7 @@ QVector3D SimplePath::getDerivative3At(float t) {
 }
 
 
-QVector3D SimplePath::getDerivative4PlusAt(float t) {
+QVector3D SimplePath::getDerivative4PlusAt(float t) const {
     return QVector3D(
         x.getDerivative4PlusAt(t),
         y.getDerivative4PlusAt(t),
@@ -3,7 +3,6 @@
 
 #include "path.h"
 #include "polynomial.h"
-#include <QOpenGLDebugLogger>
 
 /**
  * @brief The SimplePath class is a path parameterized by a
@@ -17,12 +16,26 @@ public:
     SimplePath();
     SimplePath(Polynomial x, Polynomial y, Polynomial z);
 
-    QVector3D getPathAt(float t) override;
+    QVector3D getPathAt(float t) const override;
     void updateVertexArr() override;
-    QVector3D getDerivativeAt(float t);
-    QVector3D getDerivative2At(float t);
-    QVector3D getDerivative3At(float t);
-    QVector3D getDerivative4PlusAt(float t);
+    QVector3D getDerivativeAt(float t) const;
+    QVector3D getDerivative2At(float t) const;
+    QVector3D getDerivative3At(float t) const;
+    QVector3D getDerivative4PlusAt(float t) const;
+
+    /**
+     * @brief getPathTaylorAt Returns the path and its derivatives up to order N at time t as a Taylor series.
+     */
+    template<int N>
+    inline TaylorVector3D<N> getPathTaylorAt(float t) const {
+        Taylor<float, N> time = Taylor<float, N>::variable(t);
+        Taylor<float, N> px = x.evaluate(time);
+        Taylor<float, N> py = y.evaluate(time);
+        Taylor<float, N> pz = z.evaluate(time);
+        TaylorVector3D<N> pt;
+        for (int k = 0; k <= N; k++) pt.c[k] = QVector3D(px.c[k], py.c[k], pz.c[k]);
+        return pt;
+    }
 
     inline void setX(Polynomial x) {this->x = x; updateVertexArr();}
     inline void setY(Polynomial y) {this->y = y; updateVertexArr();}
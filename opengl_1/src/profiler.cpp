@@ -0,0 +1,101 @@
+#include "profiler.h"
+#include <QSaveFile>
+#include <QTextStream>
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @brief Profiler::instance Gives the profiler shared by the whole program.
+ */
+Profiler *Profiler::instance()
+{
+    static Profiler profiler;
+    return &profiler;
+}
+
+/**
+ * @brief Profiler::record Adds a duration to a section. Does nothing while recording is off.
+ * @param name Name of the section. Must be a string literal, or otherwise outlive the profiler.
+ * @param nsecs Duration in nanoseconds.
+ */
+void Profiler::record(const char *name, qint64 nsecs)
+{
+    if (!isEnabled()) return;
+    QMutexLocker locker(&mutex);
+    Section &section = sections[QByteArray::fromRawData(name, qsizetype(std::strlen(name)))];
+    section.count++;
+    section.totalNs += nsecs;
+    if (section.recent.size() < WindowSize) {
+        section.recent.append(nsecs);
+    } else {
+        section.recent[section.next] = nsecs;
+        section.next = (section.next + 1) % WindowSize;
+    }
+}
+
+/**
+ * @brief Profiler::reset Forgets all recorded durations.
+ */
+void Profiler::reset()
+{
+    QMutexLocker locker(&mutex);
+    sections.clear();
+}
+
+/**
+ * @brief Profiler::statistics Returns the statistics of every section, ordered by name.
+ */
+QVector<Profiler::Statistics> Profiler::statistics() const
+{
+    QVector<Statistics> result;
+    {
+        QMutexLocker locker(&mutex);
+        for (auto it = sections.constBegin(); it != sections.constEnd(); ++it) {
+            const Section &section = it.value();
+            QVector<qint64> recent = section.recent;
+            std::sort(recent.begin(), recent.end());
+            qint64 sum = 0;
+            for (qint64 ns : recent) sum += ns;
+
+            Statistics stats;
+            stats.name = QString::fromUtf8(it.key());
+            stats.count = section.count;
+            stats.totalMs = section.totalNs / 1e6;
+            if (!recent.isEmpty()) {
+                stats.meanMs = sum / 1e6 / recent.size();
+                stats.medianMs = recent[recent.size() / 2] / 1e6;
+                stats.p95Ms = recent[(recent.size() - 1) * 95 / 100] / 1e6;
+                stats.maxMs = recent.last() / 1e6;
+            }
+            result.append(stats);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const Statistics &a, const Statistics &b) { return a.name < b.name; });
+    return result;
+}
+
+/**
+ * @brief Profiler::saveCsv Writes the statistics of every section as CSV, with durations in milliseconds.
+ * @param error Set to a description of the problem if the file cannot be written.
+ * @return False if the file cannot be written.
+ */
+bool Profiler::saveCsv(const QString &fileName, QString &error) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        error = file.errorString();
+        return false;
+    }
+    QTextStream out(&file);
+    out << "section,count,total_ms,mean_ms,median_ms,p95_ms,max_ms\n";
+    for (const Statistics &stats : statistics()) {
+        out << stats.name << ',' << stats.count << ',' << stats.totalMs << ',' << stats.meanMs << ','
+            << stats.medianMs << ',' << stats.p95Ms << ',' << stats.maxMs << '\n';
+    }
+    out.flush();
+    if (!file.commit()) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
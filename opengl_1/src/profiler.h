@@ -0,0 +1,79 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @brief The Profiler class collects the durations of named sections of code, such as the phases of drawing a frame or the stages of
+ * computing an envelope. For every section it keeps the count and total since the last reset, and the most recent durations, from which
+ * rolling averages and percentiles are taken. Sections are recorded from any thread.
+ * Recording is off by default, in which case timing a section costs a single check.
+ */
+class Profiler
+{
+public:
+    struct Statistics {
+        QString name;
+        qint64 count = 0;
+        double totalMs = 0;
+        // Over the most recent durations
+        double meanMs = 0;
+        double medianMs = 0;
+        double p95Ms = 0;
+        double maxMs = 0;
+    };
+
+    static const int WindowSize = 256;
+
+private:
+    struct Section {
+        qint64 count = 0;
+        qint64 totalNs = 0;
+        QVector<qint64> recent;
+        int next = 0;
+    };
+
+    std::atomic<bool> enabled{false};
+    mutable QMutex mutex;
+    // Keyed by the names passed to record, which are string literals and are not copied
+    QHash<QByteArray, Section> sections;
+
+public:
+    static Profiler *instance();
+
+    inline bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    inline void setEnabled(bool value) { enabled.store(value, std::memory_order_relaxed); }
+
+    void record(const char *name, qint64 nsecs);
+    void reset();
+    QVector<Statistics> statistics() const;
+    bool saveCsv(const QString &fileName, QString &error) const;
+};
+
+/**
+ * @brief The ProfileScope class records the time from its construction to its destruction as a section of the shared profiler.
+ * The name must be a string literal, or otherwise outlive the profiler.
+ */
+class ProfileScope
+{
+    const char *name;
+    QElapsedTimer timer;
+
+public:
+    explicit ProfileScope(const char *name) : name(Profiler::instance()->isEnabled() ? name : nullptr) {
+        if (this->name != nullptr) timer.start();
+    }
+    ~ProfileScope() {
+        if (name != nullptr) Profiler::instance()->record(name, timer.nsecsElapsed());
+    }
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#endif // PROFILER_H
@@ -1,4 +1,5 @@
 #include "enveloperenderer.h"
+#include "../logging.h"
 
 /**
  * @brief EnvelopeRenderer::EnvelopeRenderer Creates a new envelope renderer.
@@ -18,6 +19,7 @@ EnvelopeRenderer::~EnvelopeRenderer()
 {
     gl->glDeleteVertexArrays(1, &vaoEnv);
     gl->glDeleteBuffers(1, &vboEnv);
+    gl->glDeleteBuffers(1, &eboEnv);
     gl->glDeleteVertexArrays(1, &vaoCenters);
     gl->glDeleteBuffers(1, &vboCenters);
     gl->glDeleteVertexArrays(1, &vaoGrazingCurve);
@@ -32,7 +34,7 @@ EnvelopeRenderer::~EnvelopeRenderer()
 void EnvelopeRenderer::initShaders()
 {
     shader.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/vertshader.glsl");
-    shader.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/fragshader.glsl");
+    shader.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/envfragshader.glsl");
 
     shader.link();
 }
@@ -42,17 +44,19 @@ void EnvelopeRenderer::initShaders()
  */
 void EnvelopeRenderer::initBuffers()
 {
-    // Create a vertex array object and a vertex buffer object for the envelope
+    // Create a vertex array object, a vertex buffer object and an element buffer object for the envelope
     gl->glGenVertexArrays(1, &vaoEnv);
     gl->glBindVertexArray(vaoEnv);
     gl->glGenBuffers(1, &vboEnv);
     gl->glBindBuffer(GL_ARRAY_BUFFER, vboEnv);
+    gl->glGenBuffers(1, &eboEnv);
+    gl->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboEnv);
 
-    // Set up the vertex attributes
+    // Set up the vertex attributes, the shader reads the packed normal in place of a color
     gl->glEnableVertexAttribArray(0);
-    gl->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, xCoord));
+    gl->glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(EnvelopeVertex), (void *)offsetof(EnvelopeVertex, xCoord));
     gl->glEnableVertexAttribArray(1);
-    gl->glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, rVal));
+    gl->glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(EnvelopeVertex), (void *)offsetof(EnvelopeVertex, normal));
 
     // Create a vertex array object and a vertex buffer object for the centers
     gl->glGenVertexArrays(1, &vaoCenters);
@@ -99,26 +103,24 @@ void EnvelopeRenderer::initBuffers()
  */
 void EnvelopeRenderer::updateBuffers()
 {
-    qDebug() << "EnvelopeRenderer::updateBuffers";
-    QVector<Vertex>& vertexArrEnv = envelope->getVertexArr();
+    qCDebug(lcRender) << "EnvelopeRenderer::updateBuffers";
+    QVector<EnvelopeVertex>& vertexArrEnv = envelope->getVertexArr();
 
     gl->glBindBuffer(GL_ARRAY_BUFFER, vboEnv);
-    gl->glBufferData(GL_ARRAY_BUFFER, vertexArrEnv.size() * sizeof(Vertex), vertexArrEnv.data(), GL_STATIC_DRAW);
-
-    QVector<Vertex>& vertexArrCenters = envelope->getVertexArrCenters();
-
-    gl->glBindBuffer(GL_ARRAY_BUFFER, vboCenters);
-    gl->glBufferData(GL_ARRAY_BUFFER, vertexArrCenters.size() * sizeof(Vertex), vertexArrCenters.data(), GL_STATIC_DRAW);
+    gl->glBufferData(GL_ARRAY_BUFFER, vertexArrEnv.size() * sizeof(EnvelopeVertex), vertexArrEnv.data(), GL_STATIC_DRAW);
 
-    QVector<Vertex>& vertexArrGrazingCurve = envelope->getVertexArrGrazingCurve();
+    // The element buffer binding is part of the vertex array state
+    QVector<unsigned int>& indexArrEnv = envelope->getIndexArr();
 
-    gl->glBindBuffer(GL_ARRAY_BUFFER, vboGrazingCurve);
-    gl->glBufferData(GL_ARRAY_BUFFER, vertexArrGrazingCurve.size() * sizeof(Vertex), vertexArrGrazingCurve.data(), GL_STATIC_DRAW);
-
-    QVector<Vertex>& vertexArrNormals = envelope->getVertexArrNormals()[settings->timeIdx];
+    gl->glBindVertexArray(vaoEnv);
+    gl->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, eboEnv);
+    gl->glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexArrEnv.size() * sizeof(unsigned int), indexArrEnv.data(), GL_STATIC_DRAW);
+    gl->glBindVertexArray(0);
 
-    gl->glBindBuffer(GL_ARRAY_BUFFER, vboNormals);
-    gl->glBufferData(GL_ARRAY_BUFFER, vertexArrNormals.size() * sizeof(Vertex), vertexArrNormals.data(), GL_STATIC_DRAW);
+    // The overlays are uploaded when they are first drawn
+    centersUploaded = false;
+    grazingCurveUploaded = false;
+    normalsUploadedRow = -1;
 }
 
 /**
@@ -131,6 +133,10 @@ void EnvelopeRenderer::updateUniforms()
     shader.bind();
     shader.setUniformValue("modelTransform", modelTransform);
     shader.setUniformValue("projTransform", projTransform);
+    shader.setUniformValue("reflectionLines", settings->reflectionLines);
+    shader.setUniformValue("reflFreq", settings->reflFreq);
+    shader.setUniformValue("percentBlack", settings->percentBlack);
+    shader.setUniformValue("reflDirection", settings->reflDirection);
     shader.release();
 }
 
@@ -143,15 +149,24 @@ void EnvelopeRenderer::paintGL()
     shader.bind();
 
     if(settings->showEnvelope){
-        qDebug() << "EnvelopeRenderer::paintGL envelope";
+        qCDebug(lcRender) << "EnvelopeRenderer::paintGL envelope";
+        // The envelope buffer holds normals instead of colors, which the shader turns into colors
+        shader.setUniformValue("surface", true);
         // Bind envelope buffer
         gl->glBindVertexArray(vaoEnv);
         // Draw envelope
-        gl->glDrawArrays(GL_TRIANGLES,0,envelope->getVertexArr().size());
+        gl->glDrawElements(GL_TRIANGLES,envelope->getIndexArr().size(),GL_UNSIGNED_INT,nullptr);
+        shader.setUniformValue("surface", false);
     }
 
     if(settings->showToolAxis){
-        qDebug() << "EnvelopeRenderer::paintGL axis";
+        qCDebug(lcRender) << "EnvelopeRenderer::paintGL axis";
+        if (!centersUploaded) {
+            QVector<Vertex>& vertexArrCenters = envelope->getVertexArrCenters();
+            gl->glBindBuffer(GL_ARRAY_BUFFER, vboCenters);
+            gl->glBufferData(GL_ARRAY_BUFFER, vertexArrCenters.size() * sizeof(Vertex), vertexArrCenters.data(), GL_STATIC_DRAW);
+            centersUploaded = true;
+        }
         // Bind centers buffer
         gl->glBindVertexArray(vaoCenters);
         // Draw centers
@@ -159,7 +174,13 @@ void EnvelopeRenderer::paintGL()
     }
 
     if(settings->showGrazingCurve){
-        qDebug() << "EnvelopeRenderer::paintGL grazing";
+        qCDebug(lcRender) << "EnvelopeRenderer::paintGL grazing";
+        if (!grazingCurveUploaded) {
+            QVector<Vertex>& vertexArrGrazingCurve = envelope->getVertexArrGrazingCurve();
+            gl->glBindBuffer(GL_ARRAY_BUFFER, vboGrazingCurve);
+            gl->glBufferData(GL_ARRAY_BUFFER, vertexArrGrazingCurve.size() * sizeof(Vertex), vertexArrGrazingCurve.data(), GL_STATIC_DRAW);
+            grazingCurveUploaded = true;
+        }
         // Bind grazing curve buffer
         gl->glBindVertexArray(vaoGrazingCurve);
         // Draw grazing curve
@@ -167,11 +188,20 @@ void EnvelopeRenderer::paintGL()
     }
 
     if(settings->showNormals){
-        qDebug() << "EnvelopeRenderer::paintGL normals";
+        qCDebug(lcRender) << "EnvelopeRenderer::paintGL normals";
+        // The time is mapped to the grid, whose rows differ from the sectors of the settings while the mesh is coarse
+        int row = envelope->getGridRowAt(settings->t());
+        if (normalsUploadedRow != row || normalsUploadedSectorsT != envelope->getGridSectorsT()) {
+            QVector<Vertex>& vertexArrNormals = envelope->getVertexArrNormalsAt(row);
+            gl->glBindBuffer(GL_ARRAY_BUFFER, vboNormals);
+            gl->glBufferData(GL_ARRAY_BUFFER, vertexArrNormals.size() * sizeof(Vertex), vertexArrNormals.data(), GL_STATIC_DRAW);
+            normalsUploadedRow = row;
+            normalsUploadedSectorsT = envelope->getGridSectorsT();
+        }
         // Bind normals buffer
         gl->glBindVertexArray(vaoNormals);
         // Draw normals
-        gl->glDrawArrays(GL_LINES,0,envelope->getVertexArrNormals()[settings->timeIdx].size());
+        gl->glDrawArrays(GL_LINES,0,envelope->getVertexArrNormalsAt(row).size());
     }
 
     gl->glBindVertexArray(0);
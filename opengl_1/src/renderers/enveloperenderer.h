@@ -14,6 +14,7 @@ class EnvelopeRenderer : public Renderer
 
     GLuint vaoEnv;
     GLuint vboEnv;
+    GLuint eboEnv;
 
     // Centers of the 2-param family od spheres that describe the envelope
     GLuint vboCenters;
@@ -27,6 +28,13 @@ class EnvelopeRenderer : public Renderer
     GLuint vboNormals;
     GLuint vaoNormals;
 
+    // The overlays are uploaded on the first draw after the envelope changed
+    bool centersUploaded = false;
+    bool grazingCurveUploaded = false;
+    // Row of the grid the uploaded normals belong to, and the number of rows of that grid
+    int normalsUploadedRow = -1;
+    int normalsUploadedSectorsT = -1;
+
 public:
     EnvelopeRenderer();
     EnvelopeRenderer(Envelope *env);
@@ -38,7 +46,12 @@ public:
     void updateUniforms() override;
     void paintGL() override;
 
-    inline void setEnvelope(Envelope *env) { this->envelope = env; }
+    inline void setEnvelope(Envelope *env) {
+        this->envelope = env;
+        centersUploaded = false;
+        grazingCurveUploaded = false;
+        normalsUploadedRow = -1;
+    }
 };
 
 #endif // ENVELOPERENDERER_H
@@ -1,4 +1,5 @@
 #include "moverenderer.h"
+#include "../logging.h"
 
 /**
  * @brief MoveRenderer::MoveRenderer Creates a new move renderer.
@@ -83,7 +84,7 @@ void MoveRenderer::paintGL()
     shader.bind();
     if(settings->showPath)
     {
-        qDebug() << "MoveRenderer::paintGL";
+        qCDebug(lcRender) << "MoveRenderer::paintGL";
         gl->glBindVertexArray(vaoPath);
         gl->glDrawArrays(GL_LINE_STRIP, 0, move->getPathVertexArr().size());
     }
@@ -1,4 +1,5 @@
 #include "toolrenderer.h"
+#include "../logging.h"
 
 /**
  * @brief ToolRenderer::ToolRenderer Creates a new tool renderer.
@@ -33,9 +34,9 @@ void ToolRenderer::initShaders()
     shader.addShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/vertshader.glsl");
     shader.addShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/fragshader.glsl");
 
-    qDebug() << "shader link";
+    qCDebug(lcRender) << "shader link";
     shader.link();
-    qDebug() << "shader linked";
+    qCDebug(lcRender) << "shader linked";
 }
 
 /**
@@ -76,7 +77,7 @@ void ToolRenderer::initBuffers()
  */
 void ToolRenderer::updateBuffers()
 {
-    qDebug()<< "ToolRenderer::updateBuffers";
+    qCDebug(lcRender) << "ToolRenderer::updateBuffers";
     QVector<Vertex>& vertexArrTool = tool->getVertexArr();
 
     gl->glBindBuffer(GL_ARRAY_BUFFER, vboTool);
@@ -113,7 +114,7 @@ void ToolRenderer::paintGL()
     shader.bind();
 
     if(settings->showTool){
-        qDebug() << "ToolRenderer::paintGL tool";
+        qCDebug(lcRender) << "ToolRenderer::paintGL tool";
         // Bind cylinder buffer
         gl->glBindVertexArray(vaoTool);
         // Draw cylinder
@@ -122,7 +123,7 @@ void ToolRenderer::paintGL()
 
     if (settings->showSpheres)
     {
-        qDebug() << "ToolRenderer::paintGL sphere";
+        qCDebug(lcRender) << "ToolRenderer::paintGL sphere";
         // Bind sphere buffer
         gl->glBindVertexArray(vaoSph);
         // Draw sphere
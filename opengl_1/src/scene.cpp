@@ -0,0 +1,186 @@
+#include "scene.h"
+#include "envelopescheduler.h"
+#include "tools/cylinder.h"
+#include "tools/drum.h"
+
+Scene::~Scene()
+{
+    clear();
+}
+
+/**
+ * @brief Scene::clear Deletes all envelopes and tools.
+ */
+void Scene::clear()
+{
+    for (Envelope *env : envelopes) delete env;
+    for (Tool *tool : tools) delete tool;
+    envelopes.clear();
+    tools.clear();
+    inactive.clear();
+}
+
+/**
+ * @brief Scene::load Replaces the scene by the described one. The constraints are wired in one pass once all envelopes exist,
+ * as the description was checked for dependency cycles already.
+ * @param error Set to a description of the problem if the scene is invalid.
+ * @return False if the scene is invalid, in which case the scene is left empty.
+ */
+bool Scene::load(const SceneDescription &description, QString &error)
+{
+    clear();
+    if (!description.validate(error)) return false;
+
+    int n = description.envelopes.size();
+    tools.reserve(n);
+    envelopes.reserve(n);
+    for (int i = 0; i < n; i++) {
+        const EnvelopeDescription &envDesc = description.envelopes[i];
+        Tool *tool;
+        if (envDesc.toolType == Tool_Drum) {
+            Drum *drum = new Drum();
+            drum->setRadius(envDesc.radius);
+            drum->setCurvatureRadius(envDesc.curvatureRadius);
+            tool = drum;
+        } else {
+            Cylinder *cyl = new Cylinder();
+            cyl->setRadius(envDesc.radius);
+            cyl->setAngle(envDesc.angle);
+            tool = cyl;
+        }
+        tool->setHeight(envDesc.height);
+        tools.append(tool);
+
+        const float (*p)[4] = envDesc.path;
+        SimplePath path(Polynomial(p[0][0], p[0][1], p[0][2], p[0][3]),
+                        Polynomial(p[1][0], p[1][1], p[1][2], p[1][3]),
+                        Polynomial(p[2][0], p[2][1], p[2][2], p[2][3]));
+        Envelope *env = new Envelope(i, tool, path);
+        env->setSectorsA(envDesc.sectorsA);
+        env->setSectorsT(envDesc.sectorsT);
+        env->setTolerance(envDesc.tolerance);
+        env->setAxes(envDesc.axisA0, envDesc.axisA1);
+        env->setTanContinuity(envDesc.tangentContinuous);
+        env->setAdjacentAxisAngles(envDesc.axisAngle1, envDesc.axisAngle2);
+        envelopes.append(env);
+    }
+    for (int i = 0; i < n; i++) {
+        const EnvelopeDescription &envDesc = description.envelopes[i];
+        if (envDesc.adjacentA0 != -1) envelopes[i]->setAdjacentA0Envelope(envelopes[envDesc.adjacentA0]);
+        if (envDesc.adjacentA1 != -1) envelopes[i]->setAdjacentA1Envelope(envelopes[envDesc.adjacentA1]);
+    }
+    inactive.clear();
+    for (int i = 0; i < n; i++) {
+        if (!description.envelopes[i].active) inactive.insert(i);
+    }
+    return true;
+}
+
+/**
+ * @brief Scene::loadJson Replaces the scene by the one described by the JSON object.
+ * @param json Scene in the format described at the class.
+ * @param error Set to a description of the problem if the scene is invalid.
+ * @return False if the scene is invalid, in which case the scene is left empty.
+ */
+bool Scene::loadJson(const QJsonObject &json, QString &error)
+{
+    clear();
+    SceneDescription description;
+    return description.readJson(json, error) && load(description, error);
+}
+
+/**
+ * @brief Scene::loadFile Replaces the scene by the one in the file, which is read as JSON if its name ends in .json and in the binary
+ * format otherwise.
+ * @return False if the file cannot be read or the scene is invalid.
+ */
+bool Scene::loadFile(const QString &fileName, QString &error)
+{
+    clear();
+    SceneDescription description;
+    return description.load(fileName, error) && load(description, error);
+}
+
+/**
+ * @brief Scene::describe Returns the definition of the scene as plain data, which can be saved.
+ */
+SceneDescription Scene::describe() const
+{
+    SceneDescription description;
+    if (!envelopes.isEmpty()) {
+        description.sectorsA = envelopes[0]->getSectorsA();
+        description.sectorsT = envelopes[0]->getSectorsT();
+        description.tolerance = envelopes[0]->getTolerance();
+    }
+    description.envelopes.resize(envelopes.size());
+    for (int i = 0; i < envelopes.size(); i++) {
+        Envelope *env = envelopes[i];
+        EnvelopeDescription &envDesc = description.envelopes[i];
+        envDesc.active = !inactive.contains(i);
+        envDesc.toolType = env->getTool()->getType();
+        if (envDesc.toolType == Tool_Drum) {
+            Drum *drum = static_cast<Drum*>(env->getTool());
+            envDesc.radius = drum->getRadius();
+            envDesc.curvatureRadius = drum->getCurvatureRadius();
+        } else {
+            Cylinder *cyl = static_cast<Cylinder*>(env->getTool());
+            envDesc.radius = cyl->getRadius();
+            envDesc.angle = cyl->getAngle();
+        }
+        envDesc.height = env->getTool()->getHeight();
+        describeEnvelope(*env, envDesc);
+    }
+    return description;
+}
+
+/**
+ * @brief Scene::describeEnvelope Fills in the path, axis directions, constraints and sampling of the envelope, which do not depend
+ * on how the tools are kept.
+ */
+void Scene::describeEnvelope(Envelope &env, EnvelopeDescription &envDesc)
+{
+    SimplePath &path = env.getToolMovement().getPath();
+    Polynomial *polynomials[3] = {&path.getX(), &path.getY(), &path.getZ()};
+    for (int c = 0; c < 3; c++) {
+        envDesc.path[c][0] = polynomials[c]->getA();
+        envDesc.path[c][1] = polynomials[c]->getB();
+        envDesc.path[c][2] = polynomials[c]->getC();
+        envDesc.path[c][3] = polynomials[c]->getD();
+    }
+    envDesc.axisA0 = env.getToolMovement().getAxisT0();
+    envDesc.axisA1 = env.getToolMovement().getAxisT1();
+    envDesc.adjacentA0 = env.getAdjA0Envelope() != nullptr ? env.getAdjA0Envelope()->getIndex() : -1;
+    envDesc.adjacentA1 = env.getAdjA1Envelope() != nullptr ? env.getAdjA1Envelope()->getIndex() : -1;
+    envDesc.tangentContinuous = env.getTanContinuity();
+    envDesc.axisAngle1 = env.getAdjAxisAngle1();
+    envDesc.axisAngle2 = env.getAdjAxisAngle2();
+    envDesc.sectorsA = env.getSectorsA();
+    envDesc.sectorsT = env.getSectorsT();
+    envDesc.tolerance = env.getTolerance();
+}
+
+/**
+ * @brief Scene::saveFile Writes the scene to the file, as JSON if its name ends in .json and in the binary format otherwise.
+ * @return False if the file cannot be written.
+ */
+bool Scene::saveFile(const QString &fileName, QString &error) const
+{
+    return describe().save(fileName, error);
+}
+
+/**
+ * @brief Scene::compute Computes the meshes of all envelopes in the order of their dependencies.
+ * @param parallel Whether independent envelopes and the rows of an envelope are computed concurrently.
+ */
+void Scene::compute(bool parallel)
+{
+    EnvelopeScheduler scheduler;
+    scheduler.setParallel(parallel);
+    for (Envelope *env : envelopes) {
+        env->setParallel(parallel);
+    }
+    scheduler.update(envelopes);
+    for (Envelope *env : envelopes) {
+        env->setActive(!inactive.contains(env->getIndex()));
+    }
+}
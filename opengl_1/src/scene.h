@@ -0,0 +1,54 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include "envelope.h"
+#include "scenedescription.h"
+#include "tools/tool.h"
+
+/**
+ * @brief The Scene class holds a set of envelopes together with their tools, independent of any view.
+ * Scenes are read from JSON files, in which every envelope lists its tool, path, axis directions and constraints:
+ *
+ *   { "sectorsA": 20, "sectorsT": 50, "tolerance": 0,
+ *     "envelopes": [ { "tool": { "type": "cylinder", "radius": 0.5, "angle": 0, "height": 2 },
+ *                      "path": { "x": [0,0,0,0], "y": [0,0,0,0], "z": [0,0,1,0] },
+ *                      "axis": [[0,1,0], [0,1,0]] },
+ *                    { "tool": { "type": "drum", "radius": 0.5, "curvatureRadius": 4, "height": 2 },
+ *                      "adjacentA0": 0, "tangentContinuous": true, "axisAngles": [10, 30] } ] }
+ *
+ * Path polynomials are given as their coefficients a, b, c, d of at³ + bt² + ct + d. The opening angle of a cylinder is in radians,
+ * the axis angles of tangent continuous envelopes in degrees. The sectors and the tolerance apply to all envelopes, unless an envelope
+ * sets its own. Envelopes can also set "active": false. Scenes can be saved in a compact binary format as well, see SceneDescription.
+ */
+class Scene
+{
+    QVector<Tool*> tools;
+    QVector<Envelope*> envelopes;
+    // Envelopes that are not shown. Envelopes are only marked active once computed, so this is kept apart until then
+    QSet<int> inactive;
+
+public:
+    Scene() = default;
+    ~Scene();
+    Scene(const Scene &) = delete;
+    Scene &operator=(const Scene &) = delete;
+
+    bool load(const SceneDescription &description, QString &error);
+    bool loadJson(const QJsonObject &json, QString &error);
+    bool loadFile(const QString &fileName, QString &error);
+    SceneDescription describe() const;
+    bool saveFile(const QString &fileName, QString &error) const;
+    void clear();
+
+    void compute(bool parallel = true);
+
+    static void describeEnvelope(Envelope &env, EnvelopeDescription &envDesc);
+
+    inline const QVector<Envelope*> &getEnvelopes() const { return envelopes; }
+    inline const QVector<Tool*> &getTools() const { return tools; }
+};
+
+#endif // SCENE_H
@@ -0,0 +1,408 @@
+#include "scenedescription.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPair>
+#include <QSaveFile>
+#include <cmath>
+
+static bool isFinite(const QVector3D &v)
+{
+    return std::isfinite(v.x()) && std::isfinite(v.y()) && std::isfinite(v.z());
+}
+
+/**
+ * @brief checkSampling Checks that there are between one and SceneDescription::MaxSectors sectors in a and t, and that the tolerance
+ * is a non-negative number.
+ */
+static bool checkSampling(int sectorsA, int sectorsT, float tolerance, QString &error)
+{
+    if (sectorsA < 1 || sectorsT < 1 || sectorsA > SceneDescription::MaxSectors || sectorsT > SceneDescription::MaxSectors) {
+        error = QString("needs between 1 and %1 sectors in a and t").arg(SceneDescription::MaxSectors);
+        return false;
+    }
+    if (!std::isfinite(tolerance) || tolerance < 0) {
+        error = "the tolerance must be a non-negative number";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief checkGeometry Checks that the tool of an envelope has positive, finite dimensions its profile is defined for, and that its
+ * path and axis directions are finite.
+ */
+static bool checkGeometry(const EnvelopeDescription &env, QString &error)
+{
+    for (float value : {env.radius, env.height, env.curvatureRadius}) {
+        if (!std::isfinite(value) || value <= 0) {
+            error = "the radius, height and curvature radius of the tool must be positive numbers";
+            return false;
+        }
+    }
+    if (env.toolType == Tool_Cylinder) {
+        // The radius grows with tan(angle) along the height, and must stay positive up to the top
+        if (!std::isfinite(env.angle) || std::abs(env.angle) >= std::acos(0.0f) || env.radius + env.height * std::tan(env.angle) <= 0) {
+            error = "the angle of the cylinder must keep its radius positive over its height";
+            return false;
+        }
+    } else if (env.height >= 2 * env.curvatureRadius) {
+        // The profile of the drum is an arc of the curvature radius, which must span the height
+        error = "the height of the drum must be less than twice its curvature radius";
+        return false;
+    }
+    for (int c = 0; c < 3; c++) {
+        for (int k = 0; k < 4; k++) {
+            if (!std::isfinite(env.path[c][k])) {
+                error = "the path coefficients must be finite";
+                return false;
+            }
+        }
+    }
+    if (!isFinite(env.axisA0) || !isFinite(env.axisA1) || env.axisA0.isNull() || env.axisA1.isNull()) {
+        error = "the axis directions must be finite and non-zero";
+        return false;
+    }
+    if (!std::isfinite(env.axisAngle1) || !std::isfinite(env.axisAngle2)) {
+        error = "the axis angles must be finite";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief SceneDescription::validate Checks that files, which are not trusted, describe a scene that can be computed: the sectors of
+ * the scene and of every envelope are bounded and the tolerances non-negative, tools have valid dimensions, paths and axes are finite,
+ * all constraints refer to other envelopes of the scene and no envelope depends on itself.
+ * The dependency graph is walked once, depth first, so this is linear in the number of envelopes.
+ * @param error Set to a description of the first problem found.
+ * @return False if the scene is invalid.
+ */
+bool SceneDescription::validate(QString &error) const
+{
+    // The sectors of the scene become those of the sliders, which divide by them
+    if (!checkSampling(sectorsA, sectorsT, tolerance, error)) {
+        error = "the scene " + error;
+        return false;
+    }
+
+    int n = envelopes.size();
+    for (int i = 0; i < n; i++) {
+        const EnvelopeDescription &env = envelopes[i];
+        for (int adjIdx : {env.adjacentA0, env.adjacentA1}) {
+            if (adjIdx < -1 || adjIdx >= n || adjIdx == i) {
+                error = QString("envelope %1: adjacent envelope %2 must be the index of another envelope").arg(i).arg(adjIdx);
+                return false;
+            }
+        }
+        if (!checkSampling(env.sectorsA, env.sectorsT, env.tolerance, error) || !checkGeometry(env, error)) {
+            error = QString("envelope %1: ").arg(i) + error;
+            return false;
+        }
+    }
+
+    // 0 is unvisited, 1 is on the current path and 2 is done
+    QVector<char> state(n, 0);
+    QVector<QPair<int, int>> stack;
+    for (int root = 0; root < n; root++) {
+        if (state[root] != 0) continue;
+        stack.append({root, 0});
+        state[root] = 1;
+        while (!stack.isEmpty()) {
+            int i = stack.last().first;
+            int &next = stack.last().second;
+            if (next == 2) {
+                state[i] = 2;
+                stack.removeLast();
+                continue;
+            }
+            int adjIdx = next++ == 0 ? envelopes[i].adjacentA0 : envelopes[i].adjacentA1;
+            if (adjIdx == -1 || state[adjIdx] == 2) continue;
+            if (state[adjIdx] == 1) {
+                error = QString("envelope %1 depends on itself").arg(adjIdx);
+                return false;
+            }
+            state[adjIdx] = 1;
+            stack.append({adjIdx, 0});
+        }
+    }
+    return true;
+}
+
+static bool readVector(const QJsonValue &value, QVector3D &vector)
+{
+    QJsonArray array = value.toArray();
+    if (array.size() != 3) return false;
+    vector = QVector3D(array[0].toDouble(), array[1].toDouble(), array[2].toDouble());
+    return true;
+}
+
+static QJsonArray vectorToJson(const QVector3D &vector)
+{
+    return QJsonArray{vector.x(), vector.y(), vector.z()};
+}
+
+/**
+ * @brief SceneDescription::readJson Replaces the description by the scene in the JSON object, in the format described at the Scene class.
+ * @return False if the scene is invalid, in which case the description is left empty.
+ */
+bool SceneDescription::readJson(const QJsonObject &json, QString &error)
+{
+    envelopes.clear();
+    sectorsA = json["sectorsA"].toInt(20);
+    sectorsT = json["sectorsT"].toInt(50);
+    tolerance = json["tolerance"].toDouble(0);
+
+    QJsonArray envelopeArray = json["envelopes"].toArray();
+    envelopes.resize(envelopeArray.size());
+    for (int i = 0; i < envelopeArray.size(); i++) {
+        QJsonObject envJson = envelopeArray[i].toObject();
+        EnvelopeDescription &env = envelopes[i];
+        QString prefix = QString("envelope %1: ").arg(i);
+
+        QJsonObject toolJson = envJson["tool"].toObject();
+        QString type = toolJson["type"].toString("cylinder");
+        if (type == "cylinder") {
+            env.toolType = Tool_Cylinder;
+        } else if (type == "drum") {
+            env.toolType = Tool_Drum;
+        } else {
+            error = prefix + QString("unknown tool type \"%1\"").arg(type);
+            envelopes.clear();
+            return false;
+        }
+        env.radius = toolJson["radius"].toDouble(env.radius);
+        env.angle = toolJson["angle"].toDouble(env.angle);
+        env.curvatureRadius = toolJson["curvatureRadius"].toDouble(env.curvatureRadius);
+        env.height = toolJson["height"].toDouble(env.height);
+
+        if (envJson.contains("path")) {
+            QJsonObject pathJson = envJson["path"].toObject();
+            const char *coords[3] = {"x", "y", "z"};
+            for (int c = 0; c < 3; c++) {
+                QJsonArray coefficients = pathJson[coords[c]].toArray();
+                if (coefficients.size() != 4) {
+                    error = prefix + "path polynomials need four coefficients each";
+                    envelopes.clear();
+                    return false;
+                }
+                for (int k = 0; k < 4; k++) env.path[c][k] = coefficients[k].toDouble();
+            }
+        }
+
+        if (envJson.contains("axis")) {
+            QJsonArray axis = envJson["axis"].toArray();
+            if (axis.size() != 2 || !readVector(axis[0], env.axisA0) || !readVector(axis[1], env.axisA1)
+                || env.axisA0.isNull() || env.axisA1.isNull()) {
+                error = prefix + "axis needs two valid directions";
+                envelopes.clear();
+                return false;
+            }
+        }
+
+        env.active = envJson["active"].toBool(true);
+        env.adjacentA0 = envJson["adjacentA0"].toInt(-1);
+        env.adjacentA1 = envJson["adjacentA1"].toInt(-1);
+        env.tangentContinuous = envJson["tangentContinuous"].toBool(false);
+        QJsonArray angles = envJson["axisAngles"].toArray();
+        env.axisAngle1 = angles.size() > 0 ? angles[0].toDouble() : 0;
+        env.axisAngle2 = angles.size() > 1 ? angles[1].toDouble() : 0;
+        env.sectorsA = envJson["sectorsA"].toInt(sectorsA);
+        env.sectorsT = envJson["sectorsT"].toInt(sectorsT);
+        env.tolerance = envJson["tolerance"].toDouble(tolerance);
+    }
+
+    if (!validate(error)) {
+        envelopes.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief SceneDescription::toJson Returns the scene as a JSON object. Values of envelopes that equal the defaults are left out.
+ */
+QJsonObject SceneDescription::toJson() const
+{
+    QJsonObject json;
+    json["sectorsA"] = sectorsA;
+    json["sectorsT"] = sectorsT;
+    json["tolerance"] = tolerance;
+
+    const EnvelopeDescription defaults;
+    QJsonArray envelopeArray;
+    for (const EnvelopeDescription &env : envelopes) {
+        QJsonObject envJson;
+        QJsonObject toolJson;
+        toolJson["type"] = env.toolType == Tool_Drum ? "drum" : "cylinder";
+        toolJson["radius"] = env.radius;
+        toolJson["angle"] = env.angle;
+        toolJson["curvatureRadius"] = env.curvatureRadius;
+        toolJson["height"] = env.height;
+        envJson["tool"] = toolJson;
+
+        QJsonObject pathJson;
+        const char *coords[3] = {"x", "y", "z"};
+        for (int c = 0; c < 3; c++) {
+            pathJson[coords[c]] = QJsonArray{env.path[c][0], env.path[c][1], env.path[c][2], env.path[c][3]};
+        }
+        envJson["path"] = pathJson;
+        envJson["axis"] = QJsonArray{vectorToJson(env.axisA0), vectorToJson(env.axisA1)};
+
+        if (!env.active) envJson["active"] = false;
+        if (env.adjacentA0 != -1) envJson["adjacentA0"] = env.adjacentA0;
+        if (env.adjacentA1 != -1) envJson["adjacentA1"] = env.adjacentA1;
+        if (env.tangentContinuous) envJson["tangentContinuous"] = true;
+        if (env.axisAngle1 != defaults.axisAngle1 || env.axisAngle2 != defaults.axisAngle2) {
+            envJson["axisAngles"] = QJsonArray{env.axisAngle1, env.axisAngle2};
+        }
+        if (env.sectorsA != sectorsA) envJson["sectorsA"] = env.sectorsA;
+        if (env.sectorsT != sectorsT) envJson["sectorsT"] = env.sectorsT;
+        if (env.tolerance != tolerance) envJson["tolerance"] = env.tolerance;
+        envelopeArray.append(envJson);
+    }
+    json["envelopes"] = envelopeArray;
+    return json;
+}
+
+/**
+ * @brief SceneDescription::readBinary Replaces the description by the scene read from the binary stream.
+ * @return False if the stream does not hold a scene of a known version or is truncated, in which case the description is left empty.
+ */
+bool SceneDescription::readBinary(QDataStream &in, QString &error)
+{
+    envelopes.clear();
+    quint32 magic;
+    quint16 version;
+    in >> magic >> version;
+    if (in.status() != QDataStream::Ok || magic != Magic) {
+        error = "not a scene file";
+        return false;
+    }
+    if (version > Version) {
+        error = QString("scene file version %1 is newer than the supported version %2").arg(version).arg(Version);
+        return false;
+    }
+    in.setVersion(QDataStream::Qt_6_0);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    qint32 count, defaultSectorsA, defaultSectorsT;
+    in >> defaultSectorsA >> defaultSectorsT >> tolerance >> count;
+    sectorsA = defaultSectorsA;
+    sectorsT = defaultSectorsT;
+    if (in.status() != QDataStream::Ok || count < 0) {
+        error = "truncated scene file";
+        return false;
+    }
+
+    // The count is not trusted to reserve memory for, envelopes are added only once they are read completely
+    for (qint32 i = 0; i < count; i++) {
+        EnvelopeDescription env;
+        quint8 flags, toolType;
+        qint32 adjacentA0, adjacentA1, envSectorsA, envSectorsT;
+        in >> flags >> toolType >> env.radius >> env.angle >> env.curvatureRadius >> env.height;
+        for (int c = 0; c < 3; c++) {
+            for (int k = 0; k < 4; k++) in >> env.path[c][k];
+        }
+        in >> env.axisA0 >> env.axisA1 >> adjacentA0 >> adjacentA1 >> env.axisAngle1 >> env.axisAngle2
+           >> envSectorsA >> envSectorsT >> env.tolerance;
+        if (in.status() != QDataStream::Ok) break;
+        env.active = flags & 1;
+        env.tangentContinuous = flags & 2;
+        env.toolType = toolType == Tool_Drum ? Tool_Drum : Tool_Cylinder;
+        env.adjacentA0 = adjacentA0;
+        env.adjacentA1 = adjacentA1;
+        env.sectorsA = envSectorsA;
+        env.sectorsT = envSectorsT;
+        envelopes.append(env);
+    }
+    if (in.status() != QDataStream::Ok) {
+        error = "truncated scene file";
+        envelopes.clear();
+        return false;
+    }
+
+    if (!validate(error)) {
+        envelopes.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief SceneDescription::writeBinary Writes the scene to the binary stream, in the format of the current version.
+ */
+void SceneDescription::writeBinary(QDataStream &out) const
+{
+    out << Magic << Version;
+    out.setVersion(QDataStream::Qt_6_0);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    out << (qint32) sectorsA << (qint32) sectorsT << tolerance << (qint32) envelopes.size();
+    for (const EnvelopeDescription &env : envelopes) {
+        quint8 flags = (env.active ? 1 : 0) | (env.tangentContinuous ? 2 : 0);
+        out << flags << (quint8) env.toolType << env.radius << env.angle << env.curvatureRadius << env.height;
+        for (int c = 0; c < 3; c++) {
+            for (int k = 0; k < 4; k++) out << env.path[c][k];
+        }
+        out << env.axisA0 << env.axisA1 << (qint32) env.adjacentA0 << (qint32) env.adjacentA1 << env.axisAngle1 << env.axisAngle2
+            << (qint32) env.sectorsA << (qint32) env.sectorsT << env.tolerance;
+    }
+}
+
+/**
+ * @brief SceneDescription::isJsonFile Whether the scene file is stored as JSON rather than in the binary format.
+ */
+bool SceneDescription::isJsonFile(const QString &fileName)
+{
+    return fileName.endsWith(".json", Qt::CaseInsensitive);
+}
+
+/**
+ * @brief SceneDescription::load Replaces the description by the scene in the file, which is read as JSON if its name ends in .json.
+ * @return False if the file cannot be read or the scene is invalid.
+ */
+bool SceneDescription::load(const QString &fileName, QString &error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    if (!isJsonFile(fileName)) {
+        QDataStream in(&file);
+        return readBinary(in, error);
+    }
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (document.isNull()) {
+        error = parseError.errorString();
+        return false;
+    }
+    return readJson(document.object(), error);
+}
+
+/**
+ * @brief SceneDescription::save Writes the scene to the file, as JSON if its name ends in .json. The file is replaced only once it is
+ * written completely.
+ * @return False if the file cannot be written.
+ */
+bool SceneDescription::save(const QString &fileName, QString &error) const
+{
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        error = file.errorString();
+        return false;
+    }
+    if (isJsonFile(fileName)) {
+        file.write(QJsonDocument(toJson()).toJson());
+    } else {
+        QDataStream out(&file);
+        writeBinary(out);
+    }
+    if (!file.commit()) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
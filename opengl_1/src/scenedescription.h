@@ -0,0 +1,68 @@
+#ifndef SCENEDESCRIPTION_H
+#define SCENEDESCRIPTION_H
+
+#include <QDataStream>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <QVector3D>
+#include "tooltype.h"
+
+/**
+ * @brief The EnvelopeDescription struct holds everything that defines one envelope: its tool, path, axis directions and constraints.
+ * Adjacent envelopes are referred to by their index in the scene, -1 if there is none.
+ */
+struct EnvelopeDescription {
+    bool active = true;
+    ToolType toolType = Tool_Cylinder;
+    // Radius and height are shared by both tool types, the angle belongs to the cylinder and the curvature radius to the drum
+    float radius = 0.5;
+    float angle = 0;
+    float curvatureRadius = 4;
+    float height = 2;
+    // Coefficients a, b, c, d of at³ + bt² + ct + d for x(t), y(t) and z(t)
+    float path[3][4] = {{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 1, 0}};
+    QVector3D axisA0 = QVector3D(0, 1, 0);
+    QVector3D axisA1 = QVector3D(0, 1, 0);
+    int adjacentA0 = -1;
+    int adjacentA1 = -1;
+    bool tangentContinuous = false;
+    float axisAngle1 = 0;
+    float axisAngle2 = 0;
+    int sectorsA = 20;
+    int sectorsT = 50;
+    float tolerance = 0;
+};
+
+/**
+ * @brief The SceneDescription struct is a scene as plain data, which is what scene files hold.
+ * Scenes are stored either as JSON (files ending in .json, the format is described at the Scene class) or in a compact binary
+ * format written with QDataStream (by convention ending in .envs): a magic number, the format version, the envelope count and then
+ * the fields of every envelope.
+ * The sectors and tolerance of the scene are the defaults for envelopes that do not set their own in JSON.
+ */
+struct SceneDescription {
+    static const quint32 Magic = 0x454e5653; // "ENVS"
+    static const quint16 Version = 1;
+    // Largest number of sectors in a or t, which keeps the number of nodes and indices of a grid well within an int
+    static const int MaxSectors = 4096;
+
+    int sectorsA = 20;
+    int sectorsT = 50;
+    float tolerance = 0;
+    QVector<EnvelopeDescription> envelopes;
+
+    bool validate(QString &error) const;
+
+    bool readJson(const QJsonObject &json, QString &error);
+    QJsonObject toJson() const;
+    bool readBinary(QDataStream &in, QString &error);
+    void writeBinary(QDataStream &out) const;
+
+    bool load(const QString &fileName, QString &error);
+    bool save(const QString &fileName, QString &error) const;
+
+    static bool isJsonFile(const QString &fileName);
+};
+
+#endif // SCENEDESCRIPTION_H
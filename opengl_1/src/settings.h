@@ -18,13 +18,22 @@ typedef struct Settings {
     bool showToolAxis = false;
     bool showNormals = false;
     bool showSpheres = false;
+    bool showTimings = false; // Also turns recording by the profiler on
     bool reflectionLines = false;
     float reflFreq = 20;
     float percentBlack = 0.5;
+    QVector3D reflDirection = QVector3D(1,0,0);
     int aIdx = 0;
     int timeIdx = 0;
     int aSectors = 20;
     int tSectors = 50;
+    float tessellationTolerance = 0; // Largest distance between an envelope and its mesh, 0 for the uniform grid
+    int previewCoarsening = 4; // Sectors are divided by this while editing, 1 always computes full resolution meshes
+    int refineDelay = 150; // Milliseconds without edits after which coarse meshes are refined
+    bool parallelMeshes = true;
+    bool parallelEnvelopes = true;
+    bool pipelinedEnvelopes = true;
+    int threadCount = 0; // Worker threads of the task pool, applied while no meshes are computed. 0 keeps the count given on the command line
 
     const size_t NUM_ENVELOPES = 4;
 
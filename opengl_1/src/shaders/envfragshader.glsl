@@ -0,0 +1,33 @@
+#version 330 core
+
+// Define constants
+#define M_PI 3.141593
+
+// Specify the inputs to the fragment shader
+// These must have the same type and name!
+// For the envelope surface this is its normal, for the lines drawn with it a color.
+in vec3 vertColor;
+
+// Specify the Uniforms of the fragment shaders
+uniform bool surface;
+uniform bool reflectionLines;
+uniform float reflFreq;
+uniform float percentBlack;
+uniform vec3 reflDirection;
+
+// Specify the output of the fragment shader
+// Usually a vec4 describing a color (Red, Green, Blue, Alpha/Transparency)
+out vec4 fColor;
+
+void main() {
+  if (!surface || !reflectionLines) {
+    fColor = vec4(vertColor, 1.0F);
+    return;
+  }
+
+  // Reflection lines: stripes of the angle between the normal and the reference direction
+  vec3 normal = normalize(vertColor);
+  float alpha = acos(clamp(dot(normal, normalize(reflDirection)), -1.0F, 1.0F));
+  float stripe = fract(alpha * reflFreq);
+  fColor = (stripe <= percentBlack) ? vec4(0.0F, 0.0F, 0.0F, 1.0F) : vec4(1.0F, 1.0F, 1.0F, 1.0F);
+}
@@ -0,0 +1,234 @@
+#include "taskpool.h"
+
+// The pool and worker index of the current thread, if it is a worker
+static thread_local TaskPool *currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+/**
+ * @brief TaskGroup::TaskGroup Creates an empty group.
+ * @param pool Pool to run the tasks on. The shared instance if nullptr.
+ */
+TaskGroup::TaskGroup(TaskPool *pool) :
+    pool(pool != nullptr ? pool : TaskPool::instance())
+{
+
+}
+
+/**
+ * @brief TaskGroup::run Forks a task into the group.
+ * @param task Function to run.
+ * @param name Name passed to the trace hook. Must outlive the task.
+ */
+void TaskGroup::run(std::function<void()> task, const char *name)
+{
+    pending++;
+    TaskPool::Task t;
+    t.function = std::move(task);
+    t.group = this;
+    t.name = name;
+    pool->push(std::move(t));
+}
+
+/**
+ * @brief TaskGroup::wait Joins all tasks of the group, including the ones they forked. Runs queued tasks while waiting.
+ */
+void TaskGroup::wait()
+{
+    while (pending.load() > 0) {
+        if (pool->tryRun()) continue;
+        QMutexLocker locker(&pool->sleepMutex);
+        if (pending.load() > 0 && pool->queued.load() == 0) pool->wake.wait(&pool->sleepMutex);
+    }
+}
+
+/**
+ * @brief TaskPool::TaskPool Creates a pool.
+ * @param threadCount Number of worker threads. QThread::idealThreadCount() if 0.
+ */
+TaskPool::TaskPool(int threadCount)
+{
+    clock.start();
+    startWorkers(threadCount);
+}
+
+TaskPool::~TaskPool()
+{
+    stopWorkers();
+}
+
+/**
+ * @brief TaskPool::instance Gives the pool shared by the whole program.
+ */
+TaskPool *TaskPool::instance()
+{
+    static TaskPool pool;
+    return &pool;
+}
+
+/**
+ * @brief TaskPool::setThreadCount Restarts the pool with the given number of worker threads. Must only be called while the pool is idle.
+ * @param threadCount Number of worker threads. QThread::idealThreadCount() if 0.
+ */
+void TaskPool::setThreadCount(int threadCount)
+{
+    if (threadCount <= 0) threadCount = QThread::idealThreadCount();
+    if (threadCount == workers.size()) return;
+    stopWorkers();
+    startWorkers(threadCount);
+}
+
+/**
+ * @brief TaskPool::parallelFor Calls body for every index in [begin, end) and joins. Indices are handed out in chunks of at least grainSize.
+ * @param name Name passed to the trace hook for every chunk.
+ */
+void TaskPool::parallelFor(int begin, int end, const std::function<void(int)> &body, int grainSize, const char *name)
+{
+    int count = end - begin;
+    if (count <= 0) return;
+    // A few chunks per worker, so stealing can even out rows of different cost
+    int numChunks = std::min(std::max(count / std::max(grainSize, 1), 1), 4 * std::max(getThreadCount(), 1));
+    if (numChunks == 1) {
+        for (int i = begin; i < end; i++) body(i);
+        return;
+    }
+
+    TaskGroup group(this);
+    for (int chunk = 0; chunk < numChunks; chunk++) {
+        int chunkBegin = begin + (int) ((qint64) count * chunk / numChunks);
+        int chunkEnd = begin + (int) ((qint64) count * (chunk + 1) / numChunks);
+        group.run([&body, chunkBegin, chunkEnd] {
+            for (int i = chunkBegin; i < chunkEnd; i++) body(i);
+        }, name);
+    }
+    group.wait();
+}
+
+void TaskPool::startWorkers(int threadCount)
+{
+    if (threadCount <= 0) threadCount = QThread::idealThreadCount();
+    stopping = false;
+    for (int i = 0; i < threadCount; i++) {
+        workers.append(new Worker());
+    }
+    for (int i = 0; i < threadCount; i++) {
+        workers[i]->thread = QThread::create([this, i] { workerLoop(i); });
+        workers[i]->thread->start();
+    }
+}
+
+void TaskPool::stopWorkers()
+{
+    {
+        QMutexLocker locker(&sleepMutex);
+        stopping = true;
+        wake.wakeAll();
+    }
+    for (Worker *worker : workers) {
+        worker->thread->wait();
+        delete worker->thread;
+    }
+    // Tasks left behind by workers are run elsewhere
+    for (Worker *worker : workers) {
+        QMutexLocker locker(&injectedMutex);
+        for (Task &task : worker->tasks) injected.push_back(std::move(task));
+        delete worker;
+    }
+    workers.clear();
+}
+
+void TaskPool::workerLoop(int index)
+{
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        if (tryRun()) continue;
+        QMutexLocker locker(&sleepMutex);
+        if (stopping) break;
+        if (queued.load() == 0) wake.wait(&sleepMutex);
+    }
+    currentPool = nullptr;
+    currentWorker = -1;
+}
+
+/**
+ * @brief TaskPool::push Queues a task, on the deque of the current worker if called from one.
+ */
+void TaskPool::push(Task &&task)
+{
+    if (currentPool == this) {
+        Worker *worker = workers[currentWorker];
+        QMutexLocker locker(&worker->mutex);
+        worker->tasks.push_back(std::move(task));
+    } else {
+        QMutexLocker locker(&injectedMutex);
+        injected.push_back(std::move(task));
+    }
+    queued++;
+    QMutexLocker locker(&sleepMutex);
+    wake.wakeAll();
+}
+
+/**
+ * @brief TaskPool::tryRun Runs one queued task: the newest of the own deque, else the oldest injected one, else one stolen from another worker.
+ * @return False if there was no task to run.
+ */
+bool TaskPool::tryRun()
+{
+    Task task;
+    bool found = false;
+    int self = (currentPool == this) ? currentWorker : -1;
+
+    if (self >= 0) {
+        Worker *worker = workers[self];
+        QMutexLocker locker(&worker->mutex);
+        if (!worker->tasks.empty()) {
+            task = std::move(worker->tasks.back());
+            worker->tasks.pop_back();
+            found = true;
+        }
+    }
+    if (!found) {
+        QMutexLocker locker(&injectedMutex);
+        if (!injected.empty()) {
+            task = std::move(injected.front());
+            injected.pop_front();
+            found = true;
+        }
+    }
+    for (int i = 1; !found && i <= workers.size(); i++) {
+        Worker *victim = workers[(std::max(self, 0) + i) % workers.size()];
+        QMutexLocker locker(&victim->mutex);
+        if (!victim->tasks.empty()) {
+            task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    queued--;
+    execute(task);
+    return true;
+}
+
+void TaskPool::execute(Task &task)
+{
+    TaskTrace trace;
+    if (traceHook) {
+        trace.name = task.name;
+        trace.worker = (currentPool == this) ? currentWorker : -1;
+        trace.start = clock.nsecsElapsed();
+    }
+
+    task.function();
+
+    if (traceHook) {
+        trace.end = clock.nsecsElapsed();
+        traceHook(trace);
+    }
+
+    if (task.group != nullptr && --task.group->pending == 0) {
+        QMutexLocker locker(&sleepMutex);
+        wake.wakeAll();
+    }
+}
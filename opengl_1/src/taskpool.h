@@ -0,0 +1,106 @@
+#ifndef TASKPOOL_H
+#define TASKPOOL_H
+
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <deque>
+#include <functional>
+
+/**
+ * @brief The TaskTrace struct describes one finished task, as passed to the trace hook of a TaskPool.
+ * Times are in nanoseconds since the pool was created.
+ */
+struct TaskTrace {
+    const char *name = nullptr;
+    int worker = -1; // -1 if the task ran on a thread outside the pool, e.g. one joining a group
+    qint64 start = 0;
+    qint64 end = 0;
+};
+
+class TaskPool;
+
+/**
+ * @brief The TaskGroup class collects forked tasks so that they can be joined.
+ * Tasks may fork further tasks into the same group, from any thread.
+ */
+class TaskGroup
+{
+    friend class TaskPool;
+
+    TaskPool *pool;
+    std::atomic<int> pending{0};
+
+public:
+    explicit TaskGroup(TaskPool *pool = nullptr);
+    ~TaskGroup() { wait(); }
+
+    void run(std::function<void()> task, const char *name = nullptr);
+    void wait();
+};
+
+/**
+ * @brief The TaskPool class is a work-stealing thread pool shared by all compute stages.
+ * Every worker has its own deque: it pushes and pops tasks at the back, while idle workers steal from the front.
+ * Threads that join a group execute queued tasks while they wait, so tasks may fork and join recursively.
+ */
+class TaskPool
+{
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> function;
+        TaskGroup *group = nullptr;
+        const char *name = nullptr;
+    };
+
+    struct Worker {
+        QMutex mutex;
+        std::deque<Task> tasks;
+        QThread *thread = nullptr;
+    };
+
+    QVector<Worker*> workers;
+    // Tasks forked by threads outside the pool
+    QMutex injectedMutex;
+    std::deque<Task> injected;
+
+    QMutex sleepMutex;
+    QWaitCondition wake;
+    std::atomic<int> queued{0};
+    bool stopping = false;
+
+    QElapsedTimer clock;
+    std::function<void(const TaskTrace&)> traceHook;
+
+public:
+    TaskPool(int threadCount = 0);
+    ~TaskPool();
+
+    static TaskPool *instance();
+
+    void setThreadCount(int threadCount);
+    inline int getThreadCount() const { return workers.size(); }
+
+    /**
+     * @brief setTraceHook Sets a function that is called after every task. It is called from the worker threads,
+     * so it must be thread safe. Must only be set while the pool is idle.
+     */
+    inline void setTraceHook(std::function<void(const TaskTrace&)> hook) { traceHook = hook; }
+
+    void parallelFor(int begin, int end, const std::function<void(int)> &body, int grainSize = 1, const char *name = nullptr);
+
+private:
+    void startWorkers(int threadCount);
+    void stopWorkers();
+    void workerLoop(int index);
+
+    void push(Task &&task);
+    bool tryRun();
+    void execute(Task &task);
+};
+
+#endif // TASKPOOL_H
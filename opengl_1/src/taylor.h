@@ -0,0 +1,220 @@
+#ifndef TAYLOR_H
+#define TAYLOR_H
+
+#include <cmath>
+#include <QVector3D>
+
+/**
+ * @brief The Taylor class is a truncated Taylor series of a scalar function of t, used for forward mode automatic differentiation.
+ * Coefficient k holds f^(k)(t) / k!, so every arithmetic operation propagates all derivatives up to order N at once.
+ */
+template<typename T, int N>
+class Taylor
+{
+public:
+    T c[N + 1] = {};
+
+    Taylor() {}
+    Taylor(T value) { c[0] = value; }
+
+    /**
+     * @brief variable Creates the series of the independent variable itself at the given value.
+     */
+    static inline Taylor variable(T value) {
+        Taylor x(value);
+        if (N >= 1) x.c[1] = 1;
+        return x;
+    }
+
+    inline T value() const { return c[0]; }
+
+    /**
+     * @brief derivative Returns the k-th derivative.
+     */
+    inline T derivative(int k) const {
+        T factorial = 1;
+        for (int i = 2; i <= k; i++) factorial *= i;
+        return c[k] * factorial;
+    }
+
+    inline Taylor operator-() const {
+        Taylor r;
+        for (int k = 0; k <= N; k++) r.c[k] = -c[k];
+        return r;
+    }
+
+    inline Taylor &operator+=(const Taylor &o) { for (int k = 0; k <= N; k++) c[k] += o.c[k]; return *this; }
+    inline Taylor &operator-=(const Taylor &o) { for (int k = 0; k <= N; k++) c[k] -= o.c[k]; return *this; }
+    inline Taylor &operator*=(T s) { for (int k = 0; k <= N; k++) c[k] *= s; return *this; }
+
+    friend inline Taylor operator+(Taylor a, const Taylor &b) { return a += b; }
+    friend inline Taylor operator-(Taylor a, const Taylor &b) { return a -= b; }
+    friend inline Taylor operator+(Taylor a, T s) { a.c[0] += s; return a; }
+    friend inline Taylor operator+(T s, Taylor a) { a.c[0] += s; return a; }
+    friend inline Taylor operator-(Taylor a, T s) { a.c[0] -= s; return a; }
+    friend inline Taylor operator-(T s, const Taylor &a) { Taylor r = -a; r.c[0] += s; return r; }
+    friend inline Taylor operator*(Taylor a, T s) { return a *= s; }
+    friend inline Taylor operator*(T s, Taylor a) { return a *= s; }
+    friend inline Taylor operator/(Taylor a, T s) { return a *= 1 / s; }
+
+    friend inline Taylor operator*(const Taylor &a, const Taylor &b) {
+        Taylor r;
+        for (int k = 0; k <= N; k++)
+            for (int i = 0; i <= k; i++)
+                r.c[k] += a.c[i] * b.c[k - i];
+        return r;
+    }
+
+    friend inline Taylor operator/(const Taylor &a, const Taylor &b) {
+        Taylor r;
+        for (int k = 0; k <= N; k++) {
+            T sum = a.c[k];
+            for (int i = 1; i <= k; i++) sum -= b.c[i] * r.c[k - i];
+            r.c[k] = sum / b.c[0];
+        }
+        return r;
+    }
+
+    friend inline Taylor operator/(T s, const Taylor &b) { return Taylor(s) / b; }
+
+    friend inline Taylor sqrt(const Taylor &a) {
+        Taylor r;
+        r.c[0] = std::sqrt(a.c[0]);
+        for (int k = 1; k <= N; k++) {
+            T sum = a.c[k];
+            for (int i = 1; i < k; i++) sum -= r.c[i] * r.c[k - i];
+            r.c[k] = sum / (2 * r.c[0]);
+        }
+        return r;
+    }
+
+    /**
+     * @brief sincos Computes the sine and cosine series together, as each one's recurrence needs the other.
+     */
+    friend inline void sincos(const Taylor &a, Taylor &s, Taylor &co) {
+        s = Taylor(std::sin(a.c[0]));
+        co = Taylor(std::cos(a.c[0]));
+        for (int k = 1; k <= N; k++) {
+            T sumS = 0, sumC = 0;
+            for (int i = 1; i <= k; i++) {
+                sumS += i * a.c[i] * co.c[k - i];
+                sumC -= i * a.c[i] * s.c[k - i];
+            }
+            s.c[k] = sumS / k;
+            co.c[k] = sumC / k;
+        }
+    }
+
+    friend inline Taylor sin(const Taylor &a) { Taylor s, co; sincos(a, s, co); return s; }
+    friend inline Taylor cos(const Taylor &a) { Taylor s, co; sincos(a, s, co); return co; }
+    friend inline Taylor tan(const Taylor &a) { Taylor s, co; sincos(a, s, co); return s / co; }
+
+    friend inline Taylor asin(const Taylor &a) {
+        // asin(a)' = a' / sqrt(1 - a^2)
+        Taylor w = T(1) / sqrt(T(1) - a * a);
+        Taylor r(std::asin(a.c[0]));
+        for (int k = 1; k <= N; k++) {
+            T sum = 0;
+            for (int i = 1; i <= k; i++) sum += i * a.c[i] * w.c[k - i];
+            r.c[k] = sum / k;
+        }
+        return r;
+    }
+};
+
+/**
+ * @brief The TaylorVector3D class is a truncated Taylor series of a vector valued function of t.
+ * Coefficient k holds v^(k)(t) / k!.
+ */
+template<int N>
+class TaylorVector3D
+{
+public:
+    QVector3D c[N + 1];
+
+    TaylorVector3D() {}
+    TaylorVector3D(const QVector3D &value) { c[0] = value; }
+
+    /**
+     * @brief fromDerivatives Creates the series from the value and its derivatives, d[k] holding the k-th derivative.
+     */
+    static inline TaylorVector3D fromDerivatives(const QVector3D *d) {
+        TaylorVector3D v;
+        float factorial = 1;
+        for (int k = 0; k <= N; k++) {
+            if (k > 1) factorial *= k;
+            v.c[k] = d[k] / factorial;
+        }
+        return v;
+    }
+
+    inline QVector3D value() const { return c[0]; }
+
+    /**
+     * @brief derivative Returns the k-th derivative.
+     */
+    inline QVector3D derivative(int k) const {
+        float factorial = 1;
+        for (int i = 2; i <= k; i++) factorial *= i;
+        return c[k] * factorial;
+    }
+
+    /**
+     * @brief derivatives Writes the value and all derivatives to d, d[k] holding the k-th derivative.
+     */
+    inline void derivatives(QVector3D *d) const {
+        float factorial = 1;
+        for (int k = 0; k <= N; k++) {
+            if (k > 1) factorial *= k;
+            d[k] = c[k] * factorial;
+        }
+    }
+
+    inline TaylorVector3D &operator+=(const TaylorVector3D &o) { for (int k = 0; k <= N; k++) c[k] += o.c[k]; return *this; }
+    inline TaylorVector3D &operator-=(const TaylorVector3D &o) { for (int k = 0; k <= N; k++) c[k] -= o.c[k]; return *this; }
+    inline TaylorVector3D &operator*=(float s) { for (int k = 0; k <= N; k++) c[k] *= s; return *this; }
+
+    friend inline TaylorVector3D operator+(TaylorVector3D a, const TaylorVector3D &b) { return a += b; }
+    friend inline TaylorVector3D operator-(TaylorVector3D a, const TaylorVector3D &b) { return a -= b; }
+    friend inline TaylorVector3D operator*(TaylorVector3D a, float s) { return a *= s; }
+    friend inline TaylorVector3D operator*(float s, TaylorVector3D a) { return a *= s; }
+
+    friend inline TaylorVector3D operator*(const Taylor<float, N> &s, const TaylorVector3D &v) {
+        TaylorVector3D r;
+        for (int k = 0; k <= N; k++)
+            for (int i = 0; i <= k; i++)
+                r.c[k] += s.c[i] * v.c[k - i];
+        return r;
+    }
+
+    friend inline TaylorVector3D operator/(const TaylorVector3D &v, const Taylor<float, N> &s) {
+        TaylorVector3D r;
+        for (int k = 0; k <= N; k++) {
+            QVector3D sum = v.c[k];
+            for (int i = 1; i <= k; i++) sum -= s.c[i] * r.c[k - i];
+            r.c[k] = sum / s.c[0];
+        }
+        return r;
+    }
+
+    static inline Taylor<float, N> dotProduct(const TaylorVector3D &a, const TaylorVector3D &b) {
+        Taylor<float, N> r;
+        for (int k = 0; k <= N; k++)
+            for (int i = 0; i <= k; i++)
+                r.c[k] += QVector3D::dotProduct(a.c[i], b.c[k - i]);
+        return r;
+    }
+
+    static inline TaylorVector3D crossProduct(const TaylorVector3D &a, const TaylorVector3D &b) {
+        TaylorVector3D r;
+        for (int k = 0; k <= N; k++)
+            for (int i = 0; i <= k; i++)
+                r.c[k] += QVector3D::crossProduct(a.c[i], b.c[k - i]);
+        return r;
+    }
+
+    inline Taylor<float, N> length() const { return sqrt(dotProduct(*this, *this)); }
+    inline TaylorVector3D normalized() const { return *this / length(); }
+};
+
+#endif // TAYLOR_H
@@ -0,0 +1,120 @@
+#include <QtTest>
+
+#include "adaptivetessellator.h"
+#include "envelope.h"
+#include "scene.h"
+
+/**
+ * @brief The TestAdaptiveTessellator class checks that adaptive meshes are closed where the envelope continues, and that they are
+ * coarser than the uniform grid where the envelope is flat.
+ */
+class TestAdaptiveTessellator : public QObject
+{
+    Q_OBJECT
+
+    static bool compute(Scene &scene, const EnvelopeDescription &env);
+
+private slots:
+    void crackFree_data();
+    void crackFree();
+    void flatIsCoarse();
+};
+
+/**
+ * @brief TestAdaptiveTessellator::compute Computes a scene of the single envelope with a uniform mesh.
+ */
+bool TestAdaptiveTessellator::compute(Scene &scene, const EnvelopeDescription &env)
+{
+    SceneDescription description;
+    description.envelopes.append(env);
+    QString error;
+    if (!scene.load(description, error)) return false;
+    scene.compute(false);
+    return true;
+}
+
+void TestAdaptiveTessellator::crackFree_data()
+{
+    QTest::addColumn<int>("toolType");
+    QTest::addColumn<float>("tolerance");
+    QTest::addColumn<float>("angleTolerance");
+    QTest::newRow("cylinder") << int(Tool_Cylinder) << 0.01f << 0.0f;
+    QTest::newRow("drum") << int(Tool_Drum) << 0.001f << 0.0f;
+    QTest::newRow("drum with angle tolerance") << int(Tool_Drum) << 0.01f << 5.0f;
+}
+
+/**
+ * @brief TestAdaptiveTessellator::crackFree Meshes a bent envelope, whose cells are refined to different depths, and checks that every
+ * edge inside the (t,a) domain is shared by exactly two triangles that run through it in opposite directions.
+ */
+void TestAdaptiveTessellator::crackFree()
+{
+    QFETCH(int, toolType);
+    QFETCH(float, tolerance);
+    QFETCH(float, angleTolerance);
+
+    EnvelopeDescription env;
+    env.toolType = ToolType(toolType);
+    // Bends more and more towards t = 1
+    env.path[0][0] = 4;
+    env.axisA1 = QVector3D(0.5f, 1, 0);
+    Scene scene;
+    QVERIFY(compute(scene, env));
+
+    QVector<EnvelopeVertex> vertices;
+    QVector<unsigned int> indices;
+    QVector<QVector2D> parameters;
+    AdaptiveTessellator(*scene.getEnvelopes()[0], tolerance, angleTolerance).tessellate(vertices, indices, &parameters);
+    QCOMPARE(parameters.size(), vertices.size());
+    QCOMPARE(indices.size() % 3, 0);
+
+    // Sides of more than one length, as leaves of a single depth would not exercise the corners of finer neighbours on an edge
+    QSet<float> sideLengths;
+    QHash<quint64, int> edges;
+    for (int i = 0; i < indices.size(); i += 3) {
+        for (int k = 0; k < 3; k++) {
+            unsigned int from = indices[i + k];
+            unsigned int to = indices[i + (k + 1) % 3];
+            QVERIFY(from != to);
+            QVERIFY(from < (unsigned int) vertices.size());
+            edges[((quint64) from << 32) | to]++;
+            QVector2D side = parameters[to] - parameters[from];
+            if (side.x() == 0 || side.y() == 0) sideLengths.insert(side.length());
+        }
+    }
+    QVERIFY(sideLengths.size() > 1);
+
+    for (auto it = edges.constBegin(); it != edges.constEnd(); ++it) {
+        QCOMPARE(it.value(), 1);
+        unsigned int from = it.key() >> 32;
+        unsigned int to = it.key() & 0xffffffff;
+        if (edges.contains(((quint64) to << 32) | from)) continue;
+
+        // An edge without its opposite must lie on the boundary of the domain
+        QVector2D p = parameters[from];
+        QVector2D q = parameters[to];
+        bool onBoundary = (p.x() == q.x() && (p.x() == 0 || p.x() == 1)) || (p.y() == q.y() && (p.y() == 0 || p.y() == 1));
+        QVERIFY2(onBoundary, qPrintable(QString("open edge from (%1,%2) to (%3,%4)").arg(p.x()).arg(p.y()).arg(q.x()).arg(q.y())));
+    }
+}
+
+/**
+ * @brief TestAdaptiveTessellator::flatIsCoarse Meshes the envelope of a cylinder moving along a straight line, which is flat, and checks
+ * that it takes fewer triangles than the uniform grid.
+ */
+void TestAdaptiveTessellator::flatIsCoarse()
+{
+    Scene scene;
+    QVERIFY(compute(scene, EnvelopeDescription()));
+    const Envelope *envelope = scene.getEnvelopes()[0];
+
+    QVector<EnvelopeVertex> vertices;
+    QVector<unsigned int> indices;
+    AdaptiveTessellator(*envelope, 0.001f).tessellate(vertices, indices);
+    QVERIFY(!indices.isEmpty());
+    QVERIFY(indices.size() < envelope->getIndexArr().size());
+    QVERIFY(vertices.size() < envelope->getVertexArr().size());
+}
+
+QTEST_GUILESS_MAIN(TestAdaptiveTessellator)
+#include "tst_adaptivetessellator.moc"
@@ -0,0 +1,94 @@
+#include <QtTest>
+
+#include "envelopescheduler.h"
+#include "scene.h"
+
+/**
+ * @brief The TestEnvelopeScheduler class checks that the ways of scheduling the updates of dependent envelopes give the same meshes.
+ */
+class TestEnvelopeScheduler : public QObject
+{
+    Q_OBJECT
+
+    static SceneDescription describeScene();
+    static bool compute(Scene &scene, bool parallel, bool pipelined);
+
+private slots:
+    void sameMeshes_data();
+    void sameMeshes();
+};
+
+/**
+ * @brief TestEnvelopeScheduler::describeScene Returns a scene with a free envelope, a tangent continuous drum on it, a second free
+ * envelope and an axis constrained envelope between both free ones.
+ */
+SceneDescription TestEnvelopeScheduler::describeScene()
+{
+    SceneDescription description;
+    EnvelopeDescription first;
+    first.path[0][2] = 1;
+    first.axisA1 = QVector3D(0, 1, 0.2f);
+    description.envelopes.append(first);
+
+    EnvelopeDescription drum;
+    drum.toolType = Tool_Drum;
+    drum.adjacentA0 = 0;
+    drum.tangentContinuous = true;
+    drum.axisAngle1 = 10;
+    drum.axisAngle2 = 30;
+    description.envelopes.append(drum);
+
+    EnvelopeDescription second;
+    second.path[0][3] = 1.5f;
+    description.envelopes.append(second);
+
+    EnvelopeDescription constrained;
+    constrained.adjacentA0 = 0;
+    constrained.adjacentA1 = 2;
+    description.envelopes.append(constrained);
+    return description;
+}
+
+bool TestEnvelopeScheduler::compute(Scene &scene, bool parallel, bool pipelined)
+{
+    QString error;
+    if (!scene.load(describeScene(), error)) return false;
+    for (Envelope *env : scene.getEnvelopes()) env->setParallel(parallel);
+    EnvelopeScheduler scheduler;
+    scheduler.setParallel(parallel);
+    scheduler.setPipelined(pipelined);
+    scheduler.update(scene.getEnvelopes());
+    return true;
+}
+
+void TestEnvelopeScheduler::sameMeshes_data()
+{
+    QTest::addColumn<bool>("pipelined");
+    QTest::newRow("parallel") << false;
+    QTest::newRow("pipelined") << true;
+}
+
+/**
+ * @brief TestEnvelopeScheduler::sameMeshes Compares the meshes of a parallel update with those of a serial one, bit for bit.
+ */
+void TestEnvelopeScheduler::sameMeshes()
+{
+    QFETCH(bool, pipelined);
+    Scene serial;
+    QVERIFY(compute(serial, false, false));
+    Scene scheduled;
+    QVERIFY(compute(scheduled, true, pipelined));
+
+    for (int i = 0; i < serial.getEnvelopes().size(); i++) {
+        const Envelope *expected = serial.getEnvelopes()[i];
+        const Envelope *actual = scheduled.getEnvelopes()[i];
+        QVERIFY(!expected->getGridPositions().isEmpty());
+        QCOMPARE(actual->getGridPositions(), expected->getGridPositions());
+        QCOMPARE(actual->getGridNormals(), expected->getGridNormals());
+        QCOMPARE(actual->getIndexArr(), expected->getIndexArr());
+        QCOMPARE(actual->getVertexArr().size(), expected->getVertexArr().size());
+    }
+}
+
+QTEST_GUILESS_MAIN(TestEnvelopeScheduler)
+#include "tst_envelopescheduler.moc"
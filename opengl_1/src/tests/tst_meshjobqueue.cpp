@@ -0,0 +1,109 @@
+#include <QtTest>
+
+#include "meshjobqueue.h"
+
+/**
+ * @brief The TestMeshJobQueue class checks how requests to recompute meshes are coalesced and how stale jobs are cancelled.
+ */
+class TestMeshJobQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void coalescing();
+    void staleJob();
+    void independentRequestDuringJob();
+    void refinement();
+    void reset();
+};
+
+void TestMeshJobQueue::coalescing()
+{
+    MeshJobQueue queue;
+    QVERIFY(!queue.hasPending());
+    queue.request(1, MeshJobQueue::EnvelopeMesh);
+    queue.request(1, MeshJobQueue::EnvelopeMesh);
+    queue.request({1, 2}, MeshJobQueue::EnvelopeMesh);
+    queue.request(1, MeshJobQueue::ToolMesh);
+
+    QVERIFY(queue.hasPending());
+    QCOMPARE(queue.getPending(MeshJobQueue::EnvelopeMesh), QSet<int>({1, 2}));
+    QCOMPARE(queue.getPending(MeshJobQueue::ToolMesh), QSet<int>({1}));
+    QCOMPARE(queue.getNumRequested(), 5);
+    QCOMPARE(queue.getNumCoalesced(), 2);
+
+    queue.start();
+    QVERIFY(queue.isRunning());
+    QVERIFY(!queue.hasPending());
+    queue.finish(true);
+    QVERIFY(!queue.isRunning());
+    QCOMPARE(queue.getNumCompleted(), 1);
+}
+
+/**
+ * @brief TestMeshJobQueue::staleJob Checks that a request for a mesh of the running job marks it stale, and that cancelling it
+ * requeues its requests together with the new one.
+ */
+void TestMeshJobQueue::staleJob()
+{
+    MeshJobQueue queue;
+    queue.request({1, 2}, MeshJobQueue::EnvelopeMesh);
+    queue.start();
+    QVERIFY(!queue.isStale());
+
+    queue.request(2, MeshJobQueue::EnvelopeMesh);
+    QVERIFY(queue.isStale());
+    QCOMPARE(queue.getPending(MeshJobQueue::EnvelopeMesh), QSet<int>({2}));
+
+    queue.finish(false);
+    QVERIFY(!queue.isRunning());
+    QVERIFY(!queue.isStale());
+    QCOMPARE(queue.getNumCancelled(), 1);
+    QCOMPARE(queue.getPending(MeshJobQueue::EnvelopeMesh), QSet<int>({1, 2}));
+}
+
+void TestMeshJobQueue::independentRequestDuringJob()
+{
+    MeshJobQueue queue;
+    queue.request(1, MeshJobQueue::EnvelopeMesh);
+    queue.start();
+    queue.request(2, MeshJobQueue::EnvelopeMesh);
+    queue.request(1, MeshJobQueue::ToolMesh);
+    QVERIFY(!queue.isStale());
+
+    queue.finish(true);
+    QCOMPARE(queue.getPending(MeshJobQueue::EnvelopeMesh), QSet<int>({2}));
+    QCOMPARE(queue.getPending(MeshJobQueue::ToolMesh), QSet<int>({1}));
+}
+
+void TestMeshJobQueue::refinement()
+{
+    MeshJobQueue queue;
+    queue.request(1, MeshJobQueue::EnvelopeMesh);
+    queue.start();
+    queue.requestRefinement({1, 3});
+    QVERIFY(queue.isStale());
+    QCOMPARE(queue.getPending(MeshJobQueue::EnvelopeMesh), QSet<int>({1, 3}));
+    // Refinements are not edits
+    QCOMPARE(queue.getNumRequested(), 1);
+}
+
+/**
+ * @brief TestMeshJobQueue::reset Checks that a reset drops all requests and that the running job is not requeued when cancelled.
+ */
+void TestMeshJobQueue::reset()
+{
+    MeshJobQueue queue;
+    queue.request({1, 2}, MeshJobQueue::EnvelopeMesh);
+    queue.start();
+    queue.request(3, MeshJobQueue::ToolMesh);
+    queue.reset();
+    QVERIFY(queue.isStale());
+    QVERIFY(!queue.hasPending());
+
+    queue.finish(false);
+    QVERIFY(!queue.hasPending());
+}
+
+QTEST_GUILESS_MAIN(TestMeshJobQueue)
+#include "tst_meshjobqueue.moc"
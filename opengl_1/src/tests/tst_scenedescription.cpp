@@ -0,0 +1,245 @@
+#include <QtTest>
+#include <limits>
+
+#include "scenedescription.h"
+
+/**
+ * @brief The TestSceneDescription class checks reading and writing scenes, and that invalid scenes are rejected.
+ */
+class TestSceneDescription : public QObject
+{
+    Q_OBJECT
+
+    static SceneDescription describeScene();
+    static QByteArray toBinary(const SceneDescription &description);
+
+private slots:
+    void jsonBinaryRoundTrip();
+    void truncatedBinary();
+    void oversizedCount();
+    void cyclicDependencies_data();
+    void cyclicDependencies();
+    void invalidSettings_data();
+    void invalidSettings();
+    void invalidGeometry_data();
+    void invalidGeometry();
+};
+
+/**
+ * @brief TestSceneDescription::describeScene Returns a scene that sets every field to a value other than its default.
+ */
+SceneDescription TestSceneDescription::describeScene()
+{
+    SceneDescription description;
+    description.sectorsA = 12;
+    description.sectorsT = 34;
+    description.tolerance = 0.01f;
+
+    EnvelopeDescription first;
+    first.radius = 0.75f;
+    first.angle = 0.25f;
+    first.height = 3;
+    for (int c = 0; c < 3; c++) {
+        for (int k = 0; k < 4; k++) first.path[c][k] = 0.5f * c - 0.25f * k;
+    }
+    first.axisA0 = QVector3D(0, 1, 0.5f);
+    first.axisA1 = QVector3D(0.25f, 1, 0);
+    description.envelopes.append(first);
+
+    EnvelopeDescription drum;
+    drum.active = false;
+    drum.toolType = Tool_Drum;
+    drum.curvatureRadius = 5;
+    drum.adjacentA0 = 0;
+    drum.tangentContinuous = true;
+    drum.axisAngle1 = 10;
+    drum.axisAngle2 = -20;
+    drum.sectorsA = 7;
+    drum.sectorsT = 9;
+    drum.tolerance = 0.5f;
+    description.envelopes.append(drum);
+    return description;
+}
+
+QByteArray TestSceneDescription::toBinary(const SceneDescription &description)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    description.writeBinary(out);
+    return data;
+}
+
+void TestSceneDescription::jsonBinaryRoundTrip()
+{
+    SceneDescription original = describeScene();
+    QString error;
+    QVERIFY(original.validate(error));
+
+    SceneDescription fromJson;
+    QVERIFY2(fromJson.readJson(original.toJson(), error), qPrintable(error));
+    QByteArray data = toBinary(fromJson);
+    SceneDescription fromBinary;
+    QDataStream in(data);
+    QVERIFY2(fromBinary.readBinary(in, error), qPrintable(error));
+    QCOMPARE(fromBinary.toJson(), original.toJson());
+}
+
+void TestSceneDescription::truncatedBinary()
+{
+    QByteArray data = toBinary(describeScene());
+    for (int size : {0, 6, 20, (int) data.size() / 2, (int) data.size() - 1}) {
+        SceneDescription description;
+        QString error;
+        QByteArray truncated = data.left(size);
+        QDataStream in(truncated);
+        QVERIFY2(!description.readBinary(in, error), qPrintable(QString("%1 of %2 bytes").arg(size).arg(data.size())));
+        QVERIFY(description.envelopes.isEmpty());
+    }
+}
+
+/**
+ * @brief TestSceneDescription::oversizedCount Checks that a count of envelopes larger than the file holds is rejected without
+ * allocating that many envelopes.
+ */
+void TestSceneDescription::oversizedCount()
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << SceneDescription::Magic << SceneDescription::Version;
+    out.setVersion(QDataStream::Qt_6_0);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    out << (qint32) 20 << (qint32) 50 << 0.0f << (qint32) 0x7fffffff;
+
+    SceneDescription description;
+    QString error;
+    QDataStream in(data);
+    QVERIFY(!description.readBinary(in, error));
+    QVERIFY(description.envelopes.isEmpty());
+}
+
+void TestSceneDescription::cyclicDependencies_data()
+{
+    QTest::addColumn<QVector<int>>("adjacentA0");
+    QTest::addColumn<QVector<int>>("adjacentA1");
+    QTest::newRow("self") << QVector<int>{0} << QVector<int>{-1};
+    QTest::newRow("pair") << QVector<int>{1, 0} << QVector<int>{-1, -1};
+    QTest::newRow("through a1") << QVector<int>{-1, 0, -1} << QVector<int>{2, -1, 1};
+    QTest::newRow("out of range") << QVector<int>{-1, 2} << QVector<int>{-1, -1};
+}
+
+void TestSceneDescription::cyclicDependencies()
+{
+    QFETCH(QVector<int>, adjacentA0);
+    QFETCH(QVector<int>, adjacentA1);
+    SceneDescription description;
+    for (int i = 0; i < adjacentA0.size(); i++) {
+        EnvelopeDescription env;
+        env.adjacentA0 = adjacentA0[i];
+        env.adjacentA1 = adjacentA1[i];
+        description.envelopes.append(env);
+    }
+    QString error;
+    QVERIFY(!description.validate(error));
+
+    // Readers validate as well
+    SceneDescription fromJson;
+    QVERIFY(!fromJson.readJson(description.toJson(), error));
+    QVERIFY(fromJson.envelopes.isEmpty());
+    SceneDescription fromBinary;
+    QByteArray data = toBinary(description);
+    QDataStream in(data);
+    QVERIFY(!fromBinary.readBinary(in, error));
+    QVERIFY(fromBinary.envelopes.isEmpty());
+}
+
+void TestSceneDescription::invalidSettings_data()
+{
+    QTest::addColumn<int>("sectorsA");
+    QTest::addColumn<int>("sectorsT");
+    QTest::addColumn<float>("tolerance");
+    QTest::newRow("no sectors in a") << 0 << 50 << 0.0f;
+    QTest::newRow("no sectors in t") << 20 << 0 << 0.0f;
+    QTest::newRow("negative tolerance") << 20 << 50 << -1.0f;
+    QTest::newRow("infinite tolerance") << 20 << 50 << std::numeric_limits<float>::infinity();
+    QTest::newRow("too many sectors") << 20 << SceneDescription::MaxSectors + 1 << 0.0f;
+    QTest::newRow("overflowing grid") << 65536 << 65536 << 0.0f;
+}
+
+void TestSceneDescription::invalidSettings()
+{
+    QFETCH(int, sectorsA);
+    QFETCH(int, sectorsT);
+    QFETCH(float, tolerance);
+    QString error;
+
+    SceneDescription scene;
+    scene.sectorsA = sectorsA;
+    scene.sectorsT = sectorsT;
+    scene.tolerance = tolerance;
+    QVERIFY(!scene.validate(error));
+
+    SceneDescription envelope;
+    EnvelopeDescription env;
+    env.sectorsA = sectorsA;
+    env.sectorsT = sectorsT;
+    env.tolerance = tolerance;
+    envelope.envelopes.append(env);
+    QVERIFY(!envelope.validate(error));
+}
+
+void TestSceneDescription::invalidGeometry_data()
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    QTest::addColumn<int>("toolType");
+    QTest::addColumn<float>("radius");
+    QTest::addColumn<float>("angle");
+    QTest::addColumn<float>("curvatureRadius");
+    QTest::addColumn<float>("height");
+    QTest::addColumn<float>("pathCoefficient");
+    QTest::addColumn<QVector3D>("axis");
+    const QVector3D up(0, 1, 0);
+    QTest::newRow("zero radius") << int(Tool_Cylinder) << 0.0f << 0.0f << 4.0f << 2.0f << 0.0f << up;
+    QTest::newRow("negative height") << int(Tool_Cylinder) << 0.5f << 0.0f << 4.0f << -2.0f << 0.0f << up;
+    QTest::newRow("infinite curvature radius") << int(Tool_Drum) << 0.5f << 0.0f << std::numeric_limits<float>::infinity() << 2.0f
+                                               << 0.0f << up;
+    QTest::newRow("right angle") << int(Tool_Cylinder) << 0.5f << 1.5708f << 4.0f << 2.0f << 0.0f << up;
+    QTest::newRow("narrowing to a point") << int(Tool_Cylinder) << 0.5f << -0.5f << 4.0f << 2.0f << 0.0f << up;
+    QTest::newRow("drum higher than its arc") << int(Tool_Drum) << 0.5f << 0.0f << 1.0f << 2.0f << 0.0f << up;
+    QTest::newRow("nan path") << int(Tool_Cylinder) << 0.5f << 0.0f << 4.0f << 2.0f << nan << up;
+    QTest::newRow("zero axis") << int(Tool_Cylinder) << 0.5f << 0.0f << 4.0f << 2.0f << 0.0f << QVector3D();
+    QTest::newRow("nan axis") << int(Tool_Cylinder) << 0.5f << 0.0f << 4.0f << 2.0f << 0.0f << QVector3D(nan, 1, 0);
+}
+
+void TestSceneDescription::invalidGeometry()
+{
+    QFETCH(int, toolType);
+    QFETCH(float, radius);
+    QFETCH(float, angle);
+    QFETCH(float, curvatureRadius);
+    QFETCH(float, height);
+    QFETCH(float, pathCoefficient);
+    QFETCH(QVector3D, axis);
+    QString error;
+
+    SceneDescription description;
+    EnvelopeDescription env;
+    env.toolType = ToolType(toolType);
+    env.radius = radius;
+    env.angle = angle;
+    env.curvatureRadius = curvatureRadius;
+    env.height = height;
+    env.path[1][3] = pathCoefficient;
+    env.axisA1 = axis;
+    description.envelopes.append(env);
+    QVERIFY(!description.validate(error));
+    QVERIFY(!error.isEmpty());
+
+    // The binary reader does not check values itself, so it has to reject the same scene through validate
+    QByteArray data = toBinary(description);
+    QDataStream in(data);
+    SceneDescription read;
+    QVERIFY(!read.readBinary(in, error));
+}
+
+QTEST_GUILESS_MAIN(TestSceneDescription)
+#include "tst_scenedescription.moc"
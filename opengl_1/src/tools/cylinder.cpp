@@ -18,7 +18,7 @@ Cylinder::Cylinder(float baseRadius, float angle, float height, int sectors, QVe
     : Tool(ToolType::Tool_Cylinder, sectors, height, position), r(baseRadius), angle(angle)
 {}
 
-Vertex Cylinder::getToolSurfaceAt(float a, float tRad) {
+Vertex Cylinder::getToolSurfaceAt(float a, float tRad) const {
     float toolRad = getRadiusAt(a);
     QVector3D p(
         toolRad*cos(tRad),
@@ -1,8 +1,6 @@
 #ifndef CYLINDER_H
 #define CYLINDER_H
 
-#include <QOpenGLDebugLogger>
-
 #include "../vertex.h"
 #include "tool.h"
 
@@ -19,14 +17,14 @@ public:
     inline void setAngle(float angle) {this->angle=angle;}
     inline float getAngle(){ return angle; }
     
-    inline float getRadiusAt(float a) override {return r + a * height * tan(angle);}
-    inline float getRadiusDaAt(float a) override {return height * tan(angle);}
-    inline float getSphereCenterHeightAt(float a) override {return a * height + getRadiusAt(a) * tan(angle);}
-    inline float getSphereCenterHeightDaAt(float a) override {return height + getRadiusDaAt(a) * tan(angle);}
-    inline float getSphereRadiusAt(float a) override {return getRadiusAt(a) / cos(angle);}
-    inline float getSphereRadiusDaAt(float a) override {return getRadiusDaAt(a) / cos(angle);}
+    inline float getRadiusAt(float a) const override {return r + a * height * tan(angle);}
+    inline float getRadiusDaAt(float a) const override {return height * tan(angle);}
+    inline float getSphereCenterHeightAt(float a) const override {return a * height + getRadiusAt(a) * tan(angle);}
+    inline float getSphereCenterHeightDaAt(float a) const override {return height + getRadiusDaAt(a) * tan(angle);}
+    inline float getSphereRadiusAt(float a) const override {return getRadiusAt(a) / cos(angle);}
+    inline float getSphereRadiusDaAt(float a) const override {return getRadiusDaAt(a) / cos(angle);}
 
-    Vertex getToolSurfaceAt(float a, float tRad) override;
+    Vertex getToolSurfaceAt(float a, float tRad) const override;
 };
 
 #endif // CYLINDER_H
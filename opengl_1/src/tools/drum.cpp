@@ -19,50 +19,37 @@ Drum::Drum(float radius, float curveRadius, float height, int sectors, QVector3D
     : Tool(ToolType::Tool_Drum, sectors, height, position), r(radius), rho(curveRadius)
 {}
 
-float Drum::getRadiusAt(float a)
+float Drum::getRadiusAt(float a) const
 {
-    float theta = getAngleAt(a);
-    return getSphereRadiusAt(a) * cos(theta);
+    return radius(a);
 }
 
-float Drum::getRadiusDaAt(float a)
+float Drum::getRadiusDaAt(float a) const
 {
-    float theta = getAngleAt(a);
-    float theta_a = getAngleDaAt(a);
-    float c_theta = cos(theta);
-    float s_theta = sin(theta);
-    return getSphereRadiusDaAt(a) * c_theta +
-           getSphereRadiusAt(a) * -s_theta * theta_a;
+    return radius(Taylor<float, 1>::variable(a)).derivative(1);
 }
 
-float Drum::getSphereCenterHeightAt(float a)
+float Drum::getSphereCenterHeightAt(float a) const
 {
-    float theta = getAngleAt(a);
-    return D() * tan(theta) + height / 2;
+    return sphereCenterHeight(a);
 }
 
-float Drum::getSphereCenterHeightDaAt(float a)
+float Drum::getSphereCenterHeightDaAt(float a) const
 {
-    float theta = getAngleAt(a);
-    float theta_a = getAngleDaAt(a);
-    float c_theta = cos(theta);
-    return D() / (c_theta * c_theta) * theta_a;
+    return sphereCenterHeight(Taylor<float, 1>::variable(a)).derivative(1);
 }
 
-float Drum::getSphereRadiusAt(float a)
+float Drum::getSphereRadiusAt(float a) const
 {
-    float theta = getAngleAt(a);
-    return rho - D() / cos(theta);
+    return sphereRadius(a);
 }
 
-float Drum::getSphereRadiusDaAt(float a)
+float Drum::getSphereRadiusDaAt(float a) const
 {
-    float theta = getAngleAt(a);
-    float theta_a = getAngleDaAt(a);
-    return -D() * tan(theta) / cos(theta) * theta_a;
+    return sphereRadius(Taylor<float, 1>::variable(a)).derivative(1);
 }
 
-Vertex Drum::getToolSurfaceAt(float a, float tRad)
+Vertex Drum::getToolSurfaceAt(float a, float tRad) const
 {
     float toolRad = getRadiusAt(a);
     QVector3D p(
@@ -73,19 +60,3 @@ Vertex Drum::getToolSurfaceAt(float a, float tRad)
     QVector3D c(0,1,0);
     return Vertex(p,c);
 }
-
-float Drum::getAngleAt(float a)
-{
-    a = a * 2 - 1;
-    float term = (a * height) / (2 * rho);
-    return asin(term);
-}
-
-float Drum::getAngleDaAt(float a)
-{
-    a = a * 2 - 1;
-    float term = (a * height) / (2 * rho);
-    float term_a = height / (2 * rho);
-    return term_a / sqrt(1 - term * term);
-
-}
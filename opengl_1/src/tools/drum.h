@@ -2,10 +2,9 @@
 #define DRUM_H
 
 
-#include <QOpenGLDebugLogger>
-
 #include "../vertex.h"
 #include "tool.h"
+#include "../taylor.h"
 
 class Drum : public Tool
 {
@@ -20,20 +19,30 @@ public:
     inline void setCurvatureRadius(float curveRadius) {rho=curveRadius;}
     inline float getCurvatureRadius(){ return rho; }
 
-    float getRadiusAt(float a) override;
-    float getRadiusDaAt(float a) override;
-    float getSphereCenterHeightAt(float a) override;
-    float getSphereCenterHeightDaAt(float a) override;
-    float getSphereRadiusAt(float a) override;
-    float getSphereRadiusDaAt(float a) override;
+    float getRadiusAt(float a) const override;
+    float getRadiusDaAt(float a) const override;
+    float getSphereCenterHeightAt(float a) const override;
+    float getSphereCenterHeightDaAt(float a) const override;
+    float getSphereRadiusAt(float a) const override;
+    float getSphereRadiusDaAt(float a) const override;
 
-    Vertex getToolSurfaceAt(float a, float tRad) override;
+    Vertex getToolSurfaceAt(float a, float tRad) const override;
 
 private:
-    inline float D() {return rho-r;}
-
-    float getAngleAt(float a);
-    float getAngleDaAt(float a);
+    inline float D() const {return rho-r;}
+
+    /**
+     * @brief angle, radius, sphereCenterHeight and sphereRadius evaluate the profile of the drum on any type with arithmetic.
+     * Evaluated on a Taylor series of a they also give the derivatives with respect to a.
+     */
+    template<typename T>
+    inline T angle(const T &a) const { return asin((a * 2.0f - 1.0f) * height / (2 * rho)); }
+    template<typename T>
+    inline T radius(const T &a) const { return sphereRadius(a) * cos(angle(a)); }
+    template<typename T>
+    inline T sphereCenterHeight(const T &a) const { return D() * tan(angle(a)) + height / 2; }
+    template<typename T>
+    inline T sphereRadius(const T &a) const { return rho - D() / cos(angle(a)); }
 };
 
 #endif // DRUM_H
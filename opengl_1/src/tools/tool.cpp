@@ -1,9 +1,13 @@
 #include "tool.h"
+#include "../profiler.h"
+#include "../taskpool.h"
 
 void Tool::computeTool() {
-    vertexArr.clear();
-    Vertex v1,v2,v3,v4;
-    for (int aIdx = 0; aIdx<sectors;aIdx++) {
+    ProfileScope scope("tool/computeTool");
+    vertexArr.resize(6 * sectors * sectors);
+    Vertex *vertices = vertexArr.data();
+    TaskPool::instance()->parallelFor(0, sectors, [&](int aIdx) {
+        Vertex v1,v2,v3,v4;
         float a0 = (float)aIdx/sectors;
         float a1 = (float)(aIdx+1)/sectors;
         for (int tIdx = 0; tIdx < sectors;tIdx++) {
@@ -16,12 +20,13 @@ void Tool::computeTool() {
             v4 = getToolSurfaceAt(a1,t1*2*PI);
 
             // Add vertices to array
-            vertexArr.append(v1);
-            vertexArr.append(v4);
-            vertexArr.append(v2);
-            vertexArr.append(v1);
-            vertexArr.append(v3);
-            vertexArr.append(v4);
+            Vertex *quad = vertices + 6 * (aIdx * sectors + tIdx);
+            quad[0] = v1;
+            quad[1] = v4;
+            quad[2] = v2;
+            quad[3] = v1;
+            quad[4] = v3;
+            quad[5] = v4;
         }
-    }
+    }, 1, "tool ring");
 }
@@ -1,6 +1,8 @@
 #ifndef TOOL_H
 #define TOOL_H
-#include <QOpenGLDebugLogger>
+#include <QVector>
+#include <QVector3D>
+#include <cmath>
 
 #include "tooltype.h"
 #include "../vertex.h"
@@ -26,9 +28,10 @@ public:
     Tool(ToolType toolType) : toolType(toolType), vertexArr(), sectors(50), height(2), posit(QVector3D(0,0,0)) {}
     Tool(ToolType toolType, int sectors, float height, QVector3D position)
         : toolType(toolType), vertexArr(), sectors(sectors), height(height), posit(position) {}
+    virtual ~Tool() = default;
 
     inline void setHeight(float height) {this->height=height;}
-    inline float getHeight(){ return height; }
+    inline float getHeight() const { return height; }
 
     inline void setSectors(int sectors) {this->sectors=sectors;}
     inline int getSectors(){ return sectors; }
@@ -37,19 +40,20 @@ public:
     inline QVector3D getPosition() {return posit; }
 
 
-    virtual float getRadiusAt(float a) = 0;
-    virtual float getRadiusDaAt(float a) = 0;
-    virtual float getSphereCenterHeightAt(float a)=0;
-    virtual float getSphereCenterHeightDaAt(float a)=0;
-    virtual float getSphereRadiusAt(float a)=0;
-    virtual float getSphereRadiusDaAt(float a)=0;
+    virtual float getRadiusAt(float a) const = 0;
+    virtual float getRadiusDaAt(float a) const = 0;
+    virtual float getSphereCenterHeightAt(float a) const = 0;
+    virtual float getSphereCenterHeightDaAt(float a) const = 0;
+    virtual float getSphereRadiusAt(float a) const = 0;
+    virtual float getSphereRadiusDaAt(float a) const = 0;
 
-    virtual Vertex getToolSurfaceAt(float a, float tRad)=0;
+    virtual Vertex getToolSurfaceAt(float a, float tRad) const = 0;
 
 
     inline QVector3D getAxisVector() const {return axisVector.normalized(); }
     inline QVector3D getVectorPerpToAxis() const {return perpVector; }
     inline QVector<Vertex>& getVertexArr(){ return vertexArr; }
+    inline const QVector<Vertex>& getVertexArr() const { return vertexArr; }
     inline ToolType getType() { return toolType; }
 
     inline void initTool() {computeTool();}
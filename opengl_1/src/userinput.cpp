@@ -1,4 +1,4 @@
-#include <QDebug>
+#include "logging.h"
 
 #include "mainview.h"
 
@@ -9,25 +9,25 @@
 void MainView::keyPressEvent(QKeyEvent *ev) {
   switch (ev->key()) {
     case 'A':
-      qDebug() << "A pressed";
+      qCDebug(lcInput) << "A pressed";
       break;
     case 16777234: // <-
-      qDebug() << "left pressed";
+      qCDebug(lcInput) << "left pressed";
       break;
     case 16777235: // ^
-      qDebug() << "up pressed";
+      qCDebug(lcInput) << "up pressed";
       break;
     case 16777236: // ->
-      qDebug() << "right pressed";
+      qCDebug(lcInput) << "right pressed";
       break;
     case 16777237: // _
-      qDebug() << "down pressed";
+      qCDebug(lcInput) << "down pressed";
       break;
     default:
       // ev->key() is an integer. For alpha numeric characters keys it
       // equivalent with the char value ('A' == 65, '1' == 49) Alternatively,
       // you could use Qt Key enums, see http://doc.qt.io/qt-6/qt.html#Key-enum
-      qDebug() << ev->key() << "pressed";
+      qCDebug(lcInput) << ev->key() << "pressed";
       break;
   }
   // Used to update the screen after changes
@@ -42,10 +42,10 @@ void MainView::keyPressEvent(QKeyEvent *ev) {
 void MainView::keyReleaseEvent(QKeyEvent *ev) {
   switch (ev->key()) {
     case 'A':
-      qDebug() << "A released";
+      qCDebug(lcInput) << "A released";
       break;
     default:
-      qDebug() << ev->key() << "released";
+      qCDebug(lcInput) << ev->key() << "released";
       break;
   }
 
@@ -59,7 +59,7 @@ void MainView::keyReleaseEvent(QKeyEvent *ev) {
  * @param ev Mouse events.
  */
 void MainView::mouseDoubleClickEvent(QMouseEvent *ev) {
-  qDebug() << "Mouse double clicked:" << ev->button();
+  qCDebug(lcInput) << "Mouse double clicked:" << ev->button();
 
   update();
 }
@@ -70,7 +70,7 @@ void MainView::mouseDoubleClickEvent(QMouseEvent *ev) {
  * @param ev Mouse event.
  */
 void MainView::mouseMoveEvent(QMouseEvent *ev) {
-  qDebug() << "x" << ev->position().x() << "y" << ev->position().y();
+  qCDebug(lcInput) << "x" << ev->position().x() << "y" << ev->position().y();
 
   update();
 }
@@ -80,7 +80,7 @@ void MainView::mouseMoveEvent(QMouseEvent *ev) {
  * @param ev Mouse event.
  */
 void MainView::mousePressEvent(QMouseEvent *ev) {
-  qDebug() << "Mouse button pressed:" << ev->button();
+  qCDebug(lcInput) << "Mouse button pressed:" << ev->button();
 
   update();
   // Do not remove the line below, clicking must focus on this widget!
@@ -92,7 +92,7 @@ void MainView::mousePressEvent(QMouseEvent *ev) {
  * @param ev Mouse event.
  */
 void MainView::mouseReleaseEvent(QMouseEvent *ev) {
-  qDebug() << "Mouse button released" << ev->button();
+  qCDebug(lcInput) << "Mouse button released" << ev->button();
 
   update();
 }
@@ -104,7 +104,7 @@ void MainView::mouseReleaseEvent(QMouseEvent *ev) {
  */
 void MainView::wheelEvent(QWheelEvent *ev) {
   // Implement something
-  qDebug() << "Mouse wheel:" << ev->angleDelta();
+  qCDebug(lcInput) << "Mouse wheel:" << ev->angleDelta();
 
   update();
 }